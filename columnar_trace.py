@@ -0,0 +1,40 @@
+import numpy as np
+
+# Reader for the trace files written by sc_columnar_trace::trace_file.
+# All row groups are memory-mapped; the columns of a row group are views
+# into the map and are never copied.
+
+
+def row_groups(path):
+    data = np.memmap(path, dtype=np.uint8, mode='r')
+
+    if bytes(data[0:8]) != b'SCCOLTR1':
+        raise ValueError(f"{path} is not a columnar trace")
+
+    count = int(data[8:12].view(np.uint32)[0])
+    table_size = int(data[16:24].view(np.uint64)[0])
+    names = bytes(data[24:24 + table_size]).split(b'\0')[:count]
+    names = [name.decode('utf-8') for name in names]
+
+    groups = []
+    offset = 24 + table_size
+
+    while offset < len(data):
+        if bytes(data[offset:offset + 4]) != b'ROWS':
+            raise ValueError(f"{path} is corrupt at byte {offset}")
+
+        rows = int(data[offset + 8:offset + 16].view(np.uint64)[0])
+        values = data[offset + 16:offset + 16 + count * rows * 8].view(np.float64)
+        groups.append({name: values[i * rows:(i + 1) * rows] for i, name in enumerate(names)})
+        offset += 16 + count * rows * 8
+
+    return names, groups
+
+
+def read(path):
+    names, groups = row_groups(path)
+
+    if len(groups) == 1:
+        return groups[0]
+
+    return {name: np.concatenate([group[name] for group in groups]) for name in names}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_sweep.h>
+
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_sweep;
+
+// Where the ASIL of the graph model of dram-metrics-graph changes: over
+// DRAM_FIT from 1e-2 to 1e4 FIT, and over DRAM_FIT and the coverage of the
+// multi-bit error detection of SEC-DED. Argument: tolerance as fraction of
+// an axis (default 1e-6 for DRAM_FIT, 1e-3 for the 2-D sweep).
+
+int sc_main(int argc, char *argv[])
+{
+    double TOLERANCE = (argc > 1) ? std::stod(argv[1]) : 1e-6;
+    double OTHER_COMPONENTS = 1900.0;
+
+    sc_hw_graph::graph g;
+    dram_model m = build_dram_model(g, 1.0, OTHER_COMPONENTS, dram_parameters<double>());
+    g.compile();
+
+    sc_hw_graph::parameter dram_fit{"DRAM_FIT", 0};
+    sc_hw_graph::parameter mbe_dc{"DRAM_SEC_DED.RES_MBE_COV", 0};
+    axis fit{1e-2, 1e4, 20, true};
+    axis dc{0.0, 1.0, 11, false};
+
+    result r = sweep(classifier(g, m.asil, dram_fit), fit, TOLERANCE);
+
+    std::cout << "DRAM_FIT: " << r.evaluations() << " evaluations, uniform grid " << dense_points(fit, TOLERANCE)
+              << std::endl;
+    for (auto& c : r.crossings) {
+        std::cout << "  " << sc_hw_metrics::asil_levels[c.lower_asil] << " -> "
+                  << sc_hw_metrics::asil_levels[c.upper_asil] << " between " << c.lower << " and " << c.upper
+                  << " FIT" << std::endl;
+    }
+
+    g.set_coefficient(g.find("DRAM_FIT"), 0, 2300.0);
+    double tolerance = std::max(TOLERANCE, 1e-3);
+    r = sweep(classifier(g, m.asil, dram_fit, mbe_dc), fit, dc, tolerance);
+
+    std::size_t dense = dense_points(fit, dc, tolerance);
+    std::cout << "DRAM_FIT x MBE coverage: " << r.evaluations() << " evaluations, uniform grid " << dense
+              << ", " << r.boundary.size() << " boundary cells" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_cache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <systemc>
+#include <vector>
+
+using namespace sc_hw_graph;
+
+// Time per sweep point of the DRAM model with CHANNELS (default 16)
+// channels: plain evaluation, cached evaluation of new points, of points
+// that are already cached and of the same point again. The DRAM_FIT of the first channel is swept over
+// POINTS (default 1000) points from 1e-2 to 1e4 FIT, so only the nodes
+// downstream of it are hashed again, and a cached point loads the ASIL node
+// and the residual and latent sums.
+
+int sc_main(int argc, char *argv[])
+{
+    std::size_t CHANNELS = (argc > 1) ? std::stoul(argv[1]) : 16;
+    std::size_t POINTS = (argc > 2) ? std::stoul(argv[2]) : 1000;
+
+    graph g;
+    dram_model m = build_dram_model(g, 1.0, 1900.0, dram_parameters<double>(), CHANNELS);
+    g.compile();
+    node_id dram_fit = g.find((CHANNELS == 1) ? "DRAM_FIT" : "CH0.DRAM_FIT");
+    std::vector<value> outputs = {m.residual, m.latent, g.output(m.asil, 0), g.output(m.asil, 1)};
+
+    std::vector<double> fits(POINTS);
+    for (std::size_t i = 0; i < POINTS; i++) {
+        fits[i] = std::pow(10.0, -2.0 + 6.0 * i / std::max<std::size_t>(POINTS - 1, 1));
+    }
+
+    auto per_point = [POINTS](auto start, auto end) {
+        return std::chrono::duration<double, std::micro>(end - start).count() / POINTS;
+    };
+
+    double plain_spfm = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (double fit : fits) {
+        g.set_coefficient(dram_fit, 0, fit);
+        g.evaluate();
+        plain_spfm += g.spfm(m.asil);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double plain = per_point(start, end);
+
+    std::string path = (std::filesystem::temp_directory_path() / "dram-cache.bin").string();
+    std::remove(path.c_str());
+    sc_hw_cache::store cache(path);
+    sc_hw_cache::cached_graph cached(g, cache);
+
+    double pass_time[2];
+    double pass_spfm[2] = {0.0, 0.0};
+    sc_hw_cache::statistics pass_statistics[2];
+
+    for (int pass = 0; pass < 2; pass++) {
+        start = std::chrono::steady_clock::now();
+        for (double fit : fits) {
+            cached.set_coefficient(dram_fit, 0, fit);
+            auto s = cached.evaluate(outputs);
+            pass_statistics[pass].evaluated += s.evaluated;
+            pass_statistics[pass].loaded += s.loaded;
+            pass_statistics[pass].hashed += s.hashed;
+            pass_spfm[pass] += g.spfm(m.asil);
+        }
+        end = std::chrono::steady_clock::now();
+        pass_time[pass] = per_point(start, end);
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < POINTS; i++) {
+        cached.evaluate(outputs);
+    }
+    end = std::chrono::steady_clock::now();
+    double repeated = per_point(start, end);
+
+    cache.close();
+    std::remove(path.c_str());
+
+    std::cout << "Nodes: " << g.size() << " Points: " << POINTS << std::endl;
+    std::cout << "Evaluate:    " << plain << " us per point" << std::endl;
+    const char* names[] = {"Cache miss: ", "Cache hit:  "};
+    for (int pass = 0; pass < 2; pass++) {
+        std::cout << names[pass] << pass_time[pass] << " us per point, "
+                  << double(pass_statistics[pass].hashed) / POINTS << " nodes hashed, "
+                  << double(pass_statistics[pass].evaluated) / POINTS << " evaluated, "
+                  << double(pass_statistics[pass].loaded) / POINTS << " loaded" << std::endl;
+    }
+    std::cout << "Same point:  " << repeated << " us per point" << std::endl;
+
+    if (pass_spfm[0] != plain_spfm || pass_spfm[1] != plain_spfm) {
+        std::cout << "Cached results differ from the evaluation" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
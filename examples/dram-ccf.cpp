@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include <sc_fta.h>
+
+#include <iostream>
+#include <systemc>
+
+using namespace sc_core;
+using namespace sc_fta;
+
+// Redundant safety mechanisms with common cause failures. Two SEC-ECC units
+// with the defect probability of dram-fta-example both have to fail; as
+// independent events this is E_SEC_DEFECT^2, with a beta factor of 5% the
+// shared defects dominate. The same for a bank of 8 duplicated checkers of
+// which 3 have to fail, with multiple Greek letters.
+
+int sc_main(int argc, char *argv[])
+{
+    prob E_SEC_DEFECT(0.1e-9);
+    prob E_CHECKER_DEFECT(1e-7);
+
+    sc_signal<prob> sec_defect("SEC_DEFECT", E_SEC_DEFECT), both("BOTH_SEC_DEFECT");
+    sc_signal<prob> checker_defect("CHECKER_DEFECT", E_CHECKER_DEFECT), checkers("CHECKERS_DEFECT");
+
+    ccf_group sec("SEC_CCF", beta_factor(2, 0.05), 2);
+    ccf_group bank("CHECKER_CCF", multiple_greek_letters(8, {0.05, 0.3, 0.5}), 3);
+
+    sec.input(sec_defect);
+    sec.output(both);
+    bank.input(checker_defect);
+    bank.output(checkers);
+
+    sc_start();
+
+    std::cout << "SEC units, independent: " << (E_SEC_DEFECT && E_SEC_DEFECT) << std::endl;
+    std::cout << "SEC units, beta 5%:     " << both.read() << std::endl;
+    std::cout << "3 of 8 checkers, independent: "
+              << prob(binomial(8, 3) * E_CHECKER_DEFECT.value * E_CHECKER_DEFECT.value * E_CHECKER_DEFECT.value)
+              << std::endl;
+    std::cout << "3 of 8 checkers, MGL:         " << checkers.read() << std::endl;
+
+    return 0;
+}
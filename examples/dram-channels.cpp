@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_metrics.h>
+#include <sc_hw_replica.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_core;
+using namespace sc_hw_metrics;
+
+// A memory system of CHANNELS (default 16) DRAM channels with the chain of
+// dram-metrics-graph each. The chain is built once as a graph and
+// replicated; every channel only adds its values. The result is compared
+// with a graph that contains a full copy of the chain per channel.
+
+int sc_main(int argc, char *argv[])
+{
+    std::size_t CHANNELS = (argc > 1) ? std::stoul(argv[1]) : 16;
+    double DRAM_FIT = 2300.0;
+    double OTHER_COMPONENTS = 1900.0;
+
+    // One channel: DRAM_FIT in, residual and latent out
+    sc_hw_graph::graph channel;
+    auto fit = channel.basic_event("DRAM_FIT", DRAM_FIT);
+    dram_outputs o = build_dram(channel, "", fit, dram_parameters<double>());
+    auto channel_residual = channel.sum("RESIDUAL", o.residual);
+    auto channel_latent = channel.sum("LATENT", o.latent);
+    channel.compile();
+
+    sc_signal<double> dram_fit("DRAM_FIT"), residual_channels("RESIDUAL_CHANNELS"), latent_channels("LATENT_CHANNELS");
+    sc_signal<double> fit_channels("FIT_CHANNELS"), other("OTHER"), other_residual("OTHER_RESIDUAL");
+    sc_signal<double> other_latent("OTHER_LATENT"), residual("RESIDUAL"), latent("LATENT"), total("TOTAL");
+
+    basic_event dram_event("DRAM_EVENT", DRAM_FIT);
+    sc_hw_replica::replicated channels("CHANNELS", channel, {channel.find("DRAM_FIT")},
+                                       {channel_residual, channel_latent, fit}, CHANNELS);
+    basic_event other_event("ALL_OTHER", OTHER_COMPONENTS);
+    coverage other_coverage("OTHER_COV", 0.99, 1.0);
+    sum residual_sum("RESIDUAL_SUM"), latent_sum("LATENT_SUM"), total_sum("TOTAL_SUM");
+    asil metrics("ASIL", CHANNELS * DRAM_FIT + OTHER_COMPONENTS);
+
+    dram_event.output(dram_fit);
+    for (std::size_t c = 0; c < CHANNELS; c++) {
+        channels.input(c, 0)(dram_fit);
+    }
+    channels.totals[0](residual_channels);
+    channels.totals[1](latent_channels);
+    channels.totals[2](fit_channels);
+
+    // Half of the other components are safety related, as in build_dram_model
+    sc_signal<double> other_half("OTHER_HALF");
+    split other_split("OTHER_SPLIT");
+    other_event.output(other);
+    other_split.input(other);
+    other_split.outputs.bind(other_half, 0.5);
+    other_coverage.input(other_half);
+    other_coverage.output(other_residual);
+    other_coverage.latent(other_latent);
+
+    residual_sum.inputs(residual_channels);
+    residual_sum.inputs(other_residual);
+    residual_sum.output(residual);
+    latent_sum.inputs(latent_channels);
+    latent_sum.inputs(other_latent);
+    latent_sum.output(latent);
+    total_sum.inputs(fit_channels);
+    total_sum.inputs(other);
+    total_sum.output(total);
+    metrics.residual(residual);
+    metrics.latent(latent);
+    metrics.total_rate(total);
+
+    auto start = std::chrono::steady_clock::now();
+    sc_start();
+    auto end = std::chrono::steady_clock::now();
+
+    // The same system with a copy of the chain per channel
+    sc_hw_graph::graph copies;
+    dram_model m = build_dram_model(copies, DRAM_FIT, OTHER_COMPONENTS, dram_parameters<double>(), CHANNELS);
+    copies.compile();
+    copies.evaluate();
+
+    std::cout << "Channels: " << CHANNELS << " Time: " << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms" << std::endl;
+    std::cout << "Replicated: " << channel.memory_bytes() << " bytes structure + " << channels.state.memory_bytes()
+              << " bytes state" << std::endl;
+    std::cout << "Copied:     " << copies.memory_bytes() << " bytes" << std::endl;
+    std::cout << "RES: " << residual.read() << " (copied " << copies.read(m.residual) << ")" << std::endl;
+    std::cout << "LAT: " << latent.read() << " (copied " << copies.read(m.latent) << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_dse.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_dse;
+
+// Explores which safety mechanisms the DRAM model of dram-metrics-graph
+// needs for a target ASIL. "none" turns a mechanism off: no coverage, no
+// latent faults and no faults of the mechanism itself. The costs are
+// relative units, e.g. area. Arguments: target ASIL (default ASIL-A) and
+// number of threads.
+
+int sc_main(int argc, char *argv[])
+{
+    std::string TARGET = (argc > 1) ? argv[1] : "ASIL-A";
+    int THREADS = (argc > 2) ? std::stoi(argv[2]) : 1;
+
+    int target = sc_hw_metrics::asil_index(TARGET);
+    if (target < 0) {
+        SC_REPORT_FATAL("DSE", ("Unknown ASIL level " + TARGET).c_str());
+    }
+
+    std::vector<mechanism> catalog = {
+        {"SEC_ECC",
+         {{"DRAM_SEC_ECC.SEC_Coverage", 0}, {"DRAM_SEC_ECC.SEC_Coverage", 1}, {"DRAM_SEC_ECC.SEC_BROKEN", 0}},
+         {{"none", 0.0, {0.0, 1.0, 0.0}},
+          {"SEC", 4.0, {1.0, 0.0, 0.1}}}},
+        {"LINK_ECC",
+         {{"DRAM_BUS_TRIM.IF_SBE_COVERAGE", 0}, {"DRAM_BUS_TRIM.IF_SBE_COVERAGE", 1}, {"DRAM_BUS_TRIM.LINK_ECC_BROKEN", 0}},
+         {{"none", 0.0, {0.0, 1.0, 0.0}},
+          {"parity", 1.0, {1.0 - 1e-8, 1.0, 0.1}},
+          {"ECC", 3.0, {1.0, 1.0, 0.1}}}},
+        {"SEC_DED",
+         {{"DRAM_SEC_DED.RES_SBE_COV", 0}, {"DRAM_SEC_DED.RES_SBE_COV", 1},
+          {"DRAM_SEC_DED.RES_DBE_COV", 0}, {"DRAM_SEC_DED.RES_DBE_COV", 1},
+          {"DRAM_SEC_DED.RES_TBE_COV", 0}, {"DRAM_SEC_DED.RES_TBE_COV", 1},
+          {"DRAM_SEC_DED.SEC_DED_BROKEN", 0}},
+         {{"none", 0.0, {0.0, 1.0, 0.0, 1.0, 0.0, 1.0, 0.0}},
+          {"SEC-DED", 5.0, {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.1}}}},
+        {"MBE_COV",
+         {{"DRAM_SEC_DED.RES_MBE_COV", 0}, {"DRAM_SEC_DED.RES_MBE_COV", 1}},
+         {{"0%", 0.0, {0.0, 1.0}},
+          {"50%", 1.0, {0.5, 0.5}},
+          {"90%", 2.0, {0.9, 0.9}},
+          {"99%", 4.0, {0.99, 0.99}}}},
+        {"OTHER_DC",
+         {{"ALL_OTHER_COMPONENTS.OTHER_COV", 0}},
+         {{"90%", 0.0, {0.9}},
+          {"99%", 2.0, {0.99}},
+          {"99.9%", 5.0, {0.999}}}},
+        {"OTHER_LC",
+         {{"ALL_OTHER_COMPONENTS.OTHER_COV", 1}},
+         {{"60%", 0.0, {0.6}},
+          {"90%", 1.0, {0.9}},
+          {"100%", 3.0, {1.0}}}}
+    };
+
+    explorer dse([](sc_hw_graph::interval_graph& g) {
+        build_dram_model(g, interval(2300.0), interval(1900.0), dram_parameters<interval>());
+    }, "ASIL", catalog);
+
+    sc_parallel::thread_pool pool(THREADS);
+
+    auto start = std::chrono::steady_clock::now();
+    result r = dse.explore(target, pool);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Target:         " << TARGET << std::endl;
+    std::cout << "Configurations: " << r.configurations << std::endl;
+    std::cout << "Evaluated:      " << r.evaluated << std::endl;
+    std::cout << "Pruned:         " << r.pruned << std::endl;
+    std::cout << "Feasible:       " << r.feasible << std::endl;
+    std::cout << "Time:           " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    std::cout << "------------------------------ " << std::endl;
+    std::cout << "cost,spfm,lfm,asil,configuration" << std::endl;
+
+    for (auto& c : r.pareto) {
+        std::cout << c.cost << "," << c.spfm << "," << c.lfm << "," << sc_hw_metrics::asil_levels[c.asil_class]
+                  << ",\"" << dse.describe(c) << "\"" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include <iostream>
+#include <string>
+#include <systemc>
+#include <thread>
+#include <vector>
+
+#include "sc_ecc.h"
+#include "sc_hw_metrics.h"
+
+using namespace sc_core;
+using namespace sc_hw_metrics;
+
+// Derives the split rates of the DRAM model from the codes themselves: the
+// on-die (136,128) SEC code and the (72,64) SEC-DED code of the controller.
+// Every 1-, 2- and 3-bit pattern and every burst of up to 4 bits is decoded,
+// the rates are printed next to the hand-entered values of
+// dram-metrics-refactored and the SEC split of DBEs is simulated with the
+// derived rates. Then annealing chains search for codes with fewer
+// miscorrections. Arguments: number of threads and iterations per chain.
+
+static void print(const std::string& name, const sc_ecc::analysis& a)
+{
+    std::cout << name << ": " << a << std::endl;
+}
+
+static void print(const std::string& name, const std::vector<double>& rates, const std::string& model)
+{
+    std::cout << "  " << name << ":";
+    for (double r : rates) {
+        std::cout << " " << r;
+    }
+    std::cout << " (model " << model << ")" << std::endl;
+}
+
+int sc_main(int argc, char *argv[])
+{
+    unsigned THREADS = (argc > 1) ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    std::size_t ITERATIONS = (argc > 2) ? std::stoul(argv[2]) : 20000;
+
+    sc_parallel::thread_pool pool(THREADS);
+    sc_ecc::code sec = sc_ecc::code::hamming(128);
+    sc_ecc::code sec_ded = sc_ecc::code::hsiao(64);
+
+    std::vector<sc_ecc::analysis> on_die, controller;
+    for (std::size_t w = 1; w <= 3; w++) {
+        on_die.push_back(sc_ecc::analyze(sec, w, pool));
+        controller.push_back(sc_ecc::analyze(sec_ded, w, pool));
+        print("SEC     " + std::to_string(w) + "-bit", on_die.back());
+        print("SEC-DED " + std::to_string(w) + "-bit", controller.back());
+    }
+    for (std::size_t l = 2; l <= 4; l++) {
+        print("SEC-DED " + std::to_string(l) + "-burst", sc_ecc::analyze_bursts(sec_ded, l, pool));
+    }
+
+    std::cout << "Split rates:" << std::endl;
+    print("SEC DBE -> DBE, TBE", on_die[1].rates({2, 3}), "0.83 0.17");
+    print("SEC TRIM SBE", sc_ecc::trim_rates(136, 128, 1), "0.94");
+    print("SEC TRIM DBE", sc_ecc::trim_rates(136, 128, 2), "0.11 0.89");
+    print("SEC TRIM TBE", sc_ecc::trim_rates(136, 128, 3), "0.009 0.15 0.83");
+    print("SEC-DED TBE detected, miscorrected", {controller[2].detected, controller[2].miscorrected}, "0.44 0.56");
+    print("SEC-DED TRIM SBE", sc_ecc::trim_rates(72, 64, 1), "0.89");
+    print("SEC-DED TRIM DBE", sc_ecc::trim_rates(72, 64, 2), "0.20 0.79");
+    print("SEC-DED TRIM TBE", sc_ecc::trim_rates(72, 64, 3), "0.03 0.27 0.70");
+
+    sc_ecc::search_options options;
+    options.iterations = ITERATIONS;
+
+    for (auto& start : {sec, sec_ded}) {
+        std::vector<sc_ecc::candidate> best = sc_ecc::search(start, options, pool);
+        const sc_ecc::analysis& a = best.front().miscorrection;
+
+        std::cout << "Search " << (start.type == sc_ecc::decoder::sec ? "SEC" : "SEC-DED") << ": "
+                  << sc_ecc::codeword_counter(start).codewords() << " -> " << best.front().codewords
+                  << " minimum-weight codewords" << std::endl;
+        std::cout << "  " << best.front().c << std::endl;
+
+        if (start.type == sc_ecc::decoder::sec) {
+            print("SEC DBE -> DBE, TBE", a.rates({2, 3}), "0.83 0.17");
+            print("SEC DBE -> SBE, DBE, TBE (data bits)", a.observed_rates(3), "-");
+            sec = best.front().c;
+        } else {
+            print("SEC-DED TBE detected, miscorrected", {a.detected, a.miscorrected}, "0.44 0.56");
+        }
+    }
+
+    // The analysis of the best SEC code binds directly to a split
+    on_die[1] = sc_ecc::analyze(sec, 2, pool);
+
+    sc_signal<double> dbe("DBE"), res_dbe("RES_DBE"), res_tbe("RES_TBE");
+    basic_event dbe_event("DBE_EVENT", 100.0);
+    split sec_split("SEC_split");
+    std::vector<double> rates = on_die[1].rates({2, 3});
+
+    dbe_event.output(dbe);
+    sec_split.input(dbe);
+    sec_split.outputs.bind(res_dbe, rates[0]);
+    sec_split.outputs.bind(res_tbe, rates[1]);
+
+    sc_start();
+
+    std::cout << "100 FIT DBE -> RES_DBE " << res_dbe.read() << ", RES_TBE " << res_tbe.read() << std::endl;
+
+    return 0;
+}
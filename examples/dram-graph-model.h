@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef DRAM_GRAPH_MODEL_H
+#define DRAM_GRAPH_MODEL_H
+
+#include <sc_hw_graph.h>
+
+#include <string>
+#include <vector>
+
+// The DRAM model of dram-metrics-refactored for the graph backend. The
+// coverages of the safety mechanisms are parameters, the defaults are the
+// values of the refactored model. G is sc_hw_graph::graph or
+// sc_hw_graph::interval_graph and T its value type.
+
+template <class T>
+struct dram_parameters
+{
+    T sec_dc = 1.0, sec_lc = 0.0;         // DRAM_SEC_ECC.SEC_Coverage
+    T link_dc = 1.0, link_lc = 1.0;       // DRAM_BUS_TRIM.IF_SBE_COVERAGE
+    T sec_ded_dc = 1.0, sec_ded_lc = 1.0; // DRAM_SEC_DED.RES_SBE/DBE/TBE_COV
+    T mbe_dc = 0.5, mbe_lc = 0.5;         // DRAM_SEC_DED.RES_MBE_COV
+    T other_dc = 0.99, other_lc = 1.0;    // ALL_OTHER_COMPONENTS.OTHER_COV
+};
+
+struct dram_outputs
+{
+    std::vector<sc_hw_graph::value> residual;
+    std::vector<sc_hw_graph::value> latent;
+};
+
+struct dram_model
+{
+    sc_hw_graph::value dram_fit;
+    sc_hw_graph::value residual;
+    sc_hw_graph::value latent;
+    sc_hw_graph::value total;
+    sc_hw_graph::node_id asil;
+};
+
+template <class G, class T>
+dram_outputs build_dram(G& g, const std::string& prefix, sc_hw_graph::value dram_fit, const dram_parameters<T>& p)
+{
+    dram_outputs o;
+
+    // DRAM, including the all zero share used by the bus trim
+    auto dram = g.split(prefix + "DRAM", dram_fit, {0.7, 0.0748, 0.0748, 0.0748, 0.0748});
+    auto sbe = dram[0], dbe = dram[1], mbe = dram[2], wd = dram[3], az = dram[4];
+
+    // SEC-ECC
+    auto sec_coverage = g.coverage(prefix + "DRAM_SEC_ECC.SEC_Coverage", sbe, p.sec_dc, p.sec_lc);
+    auto sec_split = g.split(prefix + "DRAM_SEC_ECC.SEC_split", dbe, {0.83, 0.17});
+    auto sec_broken = g.basic_event(prefix + "DRAM_SEC_ECC.SEC_BROKEN", 0.1);
+    o.latent.push_back(sec_coverage.latent);
+    o.latent.push_back(sec_broken);
+
+    // DRAM-TRIM
+    auto t_sbe = g.split(prefix + "DRAM_SEC_TRIM.RES_SBE_SPLIT", sec_coverage.output, {0.94});
+    auto t_dbe = g.split(prefix + "DRAM_SEC_TRIM.RES_DBE_SPLIT", sec_split[0], {0.11, 0.89});
+    auto t_tbe = g.split(prefix + "DRAM_SEC_TRIM.RES_TBE_SPLIT", sec_split[1], {0.009, 0.15, 0.83});
+    sbe = g.sum(prefix + "DRAM_SEC_TRIM.RES_SBE_SUM", {t_sbe[0], t_dbe[0], t_tbe[0]});
+    dbe = g.sum(prefix + "DRAM_SEC_TRIM.RES_DBE_SUM", {t_dbe[1], t_tbe[1]});
+    auto tbe = t_tbe[2];
+
+    // BUS-TRIM
+    auto b_sbe = g.split(prefix + "DRAM_BUS_TRIM.RES_SBE_SPLIT", sbe, {0.438});
+    auto b_dbe = g.split(prefix + "DRAM_BUS_TRIM.RES_DBE_SPLIT", dbe, {0.496, 0.314});
+    auto b_tbe = g.split(prefix + "DRAM_BUS_TRIM.RES_TBE_SPLIT", tbe, {0.325, 0.419, 0.175});
+    sbe = g.sum(prefix + "DRAM_BUS_TRIM.RES_SBE_SUM", {b_sbe[0], b_dbe[0], b_tbe[0]});
+    dbe = g.sum(prefix + "DRAM_BUS_TRIM.RES_DBE_SUM", {b_dbe[1], b_tbe[1]});
+    tbe = b_tbe[2];
+    auto if_sbe = g.basic_event(prefix + "DRAM_BUS_TRIM.IF_SBE", 5e9);
+    auto if_sbe_coverage = g.coverage(prefix + "DRAM_BUS_TRIM.IF_SBE_COVERAGE", if_sbe, p.link_dc, p.link_lc);
+    auto link_ecc_broken = g.basic_event(prefix + "DRAM_BUS_TRIM.LINK_ECC_BROKEN", 0.1);
+    mbe = g.sum(prefix + "DRAM_BUS_TRIM.RES_MBE_SUM", {mbe, if_sbe_coverage.output});
+    o.latent.push_back(if_sbe_coverage.latent);
+    o.latent.push_back(link_ecc_broken);
+
+    // SEC-DED
+    auto d_sbe = g.coverage(prefix + "DRAM_SEC_DED.RES_SBE_COV", sbe, p.sec_ded_dc, p.sec_ded_lc);
+    auto d_dbe = g.coverage(prefix + "DRAM_SEC_DED.RES_DBE_COV", dbe, p.sec_ded_dc, p.sec_ded_lc);
+    auto d_tbe_split = g.split(prefix + "DRAM_SEC_DED.RES_TBE_SPLIT", tbe, {0.44, 0.56});
+    auto d_tbe = g.coverage(prefix + "DRAM_SEC_DED.RES_TBE_COV", d_tbe_split[0], p.sec_ded_dc, p.sec_ded_lc);
+    auto d_mbe = g.coverage(prefix + "DRAM_SEC_DED.RES_MBE_COV", mbe, p.mbe_dc, p.mbe_lc);
+    auto sec_ded_broken = g.basic_event(prefix + "DRAM_SEC_DED.SEC_DED_BROKEN", 0.1);
+    mbe = g.sum(prefix + "DRAM_SEC_DED.RES_MBE_SUM", {d_tbe_split[1], d_mbe.output});
+    o.latent.insert(o.latent.end(), {d_sbe.latent, d_dbe.latent, d_tbe.latent, d_mbe.latent, sec_ded_broken});
+
+    // SEC-DED-TRIM
+    auto dt_sbe = g.split(prefix + "DRAM_SEC_DED_TRIM.RES_SBE_SPLIT", d_sbe.output, {0.89});
+    auto dt_dbe = g.split(prefix + "DRAM_SEC_DED_TRIM.RES_DBE_SPLIT", d_dbe.output, {0.20, 0.79});
+    auto dt_tbe = g.split(prefix + "DRAM_SEC_DED_TRIM.RES_TBE_SPLIT", d_tbe.output, {0.03, 0.27, 0.70});
+    sbe = g.sum(prefix + "DRAM_SEC_DED_TRIM.RES_SBE_SUM", {dt_sbe[0], dt_dbe[0], dt_tbe[0]});
+    dbe = g.sum(prefix + "DRAM_SEC_DED_TRIM.RES_DBE_SUM", {dt_dbe[1], dt_tbe[1]});
+    o.residual.insert(o.residual.end(), {sbe, dbe, dt_tbe[2], mbe, wd, az});
+
+    return o;
+}
+
+// DRAM channels and all other components up to the ASIL node
+template <class G, class T>
+dram_model build_dram_model(G& g, T DRAM_FIT, T OTHER_COMPONENTS, const dram_parameters<T>& p, int channels = 1)
+{
+    dram_model m;
+    std::vector<sc_hw_graph::value> residual, latent, total;
+
+    for (int c = 0; c < channels; c++) {
+        std::string prefix = (channels == 1) ? "" : "CH" + std::to_string(c) + ".";
+        auto dram_fit = g.basic_event(prefix + "DRAM_FIT", DRAM_FIT);
+        dram_outputs o = build_dram(g, prefix, dram_fit, p);
+        residual.insert(residual.end(), o.residual.begin(), o.residual.end());
+        latent.insert(latent.end(), o.latent.begin(), o.latent.end());
+        total.push_back(dram_fit);
+        m.dram_fit = dram_fit;
+    }
+
+    // Other
+    auto all_other = g.basic_event("ALL_OTHER_COMPONENTS.ALL_OTHER", OTHER_COMPONENTS);
+    auto other_split = g.split("ALL_OTHER_COMPONENTS.OTHER_SPLIT", all_other, {0.5});
+    auto other_cov = g.coverage("ALL_OTHER_COMPONENTS.OTHER_COV", other_split[0], p.other_dc, p.other_lc);
+    residual.push_back(other_cov.output);
+    latent.push_back(other_cov.latent);
+    total.push_back(all_other);
+
+    // ASIL
+    m.residual = g.sum("RESIDUAL", residual);
+    m.latent = g.sum("LATENT", latent);
+    m.total = g.sum("TOTAL", total);
+    m.asil = g.asil("ASIL", m.residual, m.latent, m.total);
+
+    return m;
+}
+
+#endif // DRAM_GRAPH_MODEL_H
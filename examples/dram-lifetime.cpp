@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include <sc_hw_metrics.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_core;
+using namespace sc_hw_metrics;
+
+// DRAM SBEs and DBEs over a vehicle lifetime of 15 years. The rates follow a
+// bathtub curve (early failures, constant rate, wear-out) and are
+// accelerated in the hot half of every year. The profile is sampled into
+// SEGMENTS pieces (default 100000). The simulation only stops in the middle
+// of every season to print the metrics, in between it wakes up at changes
+// of the rates.
+// The default time resolution of 1 ps covers only about 200 days, so this
+// example sets it to 1 ms.
+
+static const double LIFETIME = 15 * 8760.0; // hours
+
+static double bathtub(double hours)
+{
+    double early = 4.0 * std::exp(-hours / 2000.0);
+    double wearout = 3.0 * std::pow(hours / LIFETIME, 3);
+    double summer = std::fmod(hours, 8760.0) < 4380.0;
+    return (1.0 + early + wearout) * arrhenius(0.7, summer ? 70.0 : 40.0, 55.0);
+}
+
+int sc_main(int argc, char *argv[])
+{
+    std::size_t SEGMENTS = (argc > 1) ? std::stoul(argv[1]) : 100000;
+    double DRAM_FIT = 2300.0;
+    double OTHER_COMPONENTS = 1900.0;
+
+    sc_set_time_resolution(1, SC_MS);
+    sc_time end(LIFETIME * 3600.0, SC_SEC);
+
+    auto profile = [&](double fit) {
+        return sample_rate([fit](const sc_time& t) { return fit * bathtub(t.to_seconds() / 3600.0); }, end, SEGMENTS);
+    };
+
+    sc_signal<double> sbe("SBE"), dbe("DBE"), other("OTHER");
+    sc_signal<double> res_sbe("RES_SBE"), lat_sbe("LAT_SBE"), res_dbe("RES_DBE"), lat_dbe("LAT_DBE");
+    sc_signal<double> residual("RESIDUAL"), latent("LATENT"), total("TOTAL");
+
+    profile_event sbe_event("SBE_EVENT", profile(0.7 * DRAM_FIT));
+    profile_event dbe_event("DBE_EVENT", profile(0.0748 * DRAM_FIT));
+    basic_event other_event("OTHER_EVENT", OTHER_COMPONENTS);
+    coverage sec("SEC", 1.0, 1.0);
+    coverage sec_ded("SEC_DED", 0.99, 0.5);
+    sum residual_sum("RESIDUAL_SUM"), latent_sum("LATENT_SUM"), total_sum("TOTAL_SUM");
+    asil metrics("ASIL", DRAM_FIT + OTHER_COMPONENTS);
+
+    sbe_event.output(sbe);
+    dbe_event.output(dbe);
+    other_event.output(other);
+    sec.input(sbe);
+    sec.output(res_sbe);
+    sec.latent(lat_sbe);
+    sec_ded.input(dbe);
+    sec_ded.output(res_dbe);
+    sec_ded.latent(lat_dbe);
+    residual_sum.inputs(res_sbe);
+    residual_sum.inputs(res_dbe);
+    residual_sum.output(residual);
+    latent_sum.inputs(lat_sbe);
+    latent_sum.inputs(lat_dbe);
+    latent_sum.output(latent);
+    total_sum.inputs(sbe);
+    total_sum.inputs(dbe);
+    total_sum.inputs(other);
+    total_sum.output(total);
+    metrics.residual(residual);
+    metrics.latent(latent);
+    metrics.total_rate(total);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::cout << std::setw(6) << "Year" << std::setw(8) << "Season" << std::setw(12) << "Residual" << std::setw(12) << "Latent"
+              << std::setw(10) << "SPFM" << std::setw(10) << "LFM" << "  ASIL" << std::endl;
+
+    sc_start(sc_time(2190.0 * 3600.0, SC_SEC));
+
+    for (int season = 0; season < 30; season++) {
+        std::cout << std::setw(6) << season / 2 + 1 << std::setw(8) << (season % 2 ? "winter" : "summer") << std::setw(12) << residual.read() << std::setw(12) << latent.read()
+                  << std::setw(10) << metrics.spfm << std::setw(10) << metrics.lfm << "  " << metrics.asil_level
+                  << std::endl;
+        sc_start(sc_time(4380.0 * 3600.0, SC_SEC));
+    }
+
+    auto stop = std::chrono::steady_clock::now();
+
+    std::cout << "Segments: " << sbe_event.segments.size() + dbe_event.segments.size()
+              << " Time: " << std::chrono::duration<double, std::milli>(stop - start).count() << " ms" << std::endl;
+
+    return 0;
+}
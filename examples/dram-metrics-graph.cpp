@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_graph;
+
+// Same model as dram-metrics-refactored, built with the graph backend.
+// With a second argument the DRAM chain is instantiated once per channel,
+// which is used to check memory footprint and evaluation time of large
+// models. A third argument evaluates the graph on that many threads.
+
+int sc_main(int argc, char *argv[])
+{
+    double DRAM_FIT = (argc == 1) ? 2300.0 : std::stod(argv[1]);
+    int CHANNELS = (argc > 2) ? std::stoi(argv[2]) : 1;
+    int THREADS = (argc > 3) ? std::stoi(argv[3]) : 1;
+    double OTHER_COMPONENTS = 1900.0;
+
+    graph g;
+    dram_model m = build_dram_model(g, DRAM_FIT, OTHER_COMPONENTS, dram_parameters<double>(), CHANNELS);
+
+    g.schedule();
+
+    sc_parallel::thread_pool pool(THREADS);
+
+    auto start = std::chrono::steady_clock::now();
+    if (THREADS == 1) {
+        g.evaluate();
+    } else {
+        g.evaluate(pool);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "TOTAL: RES_SUM: " << g.read(m.residual) << std::endl;
+    std::cout << "TOTAL: LAT_SUM: " << g.read(m.latent) << std::endl;
+    std::cout << "------------------------------ " << std::endl;
+    std::cout << "RES:   " << g.read(m.residual) << std::endl;
+    std::cout << "LAT:   " << g.read(m.latent) << std::endl;
+    std::cout << "TOTAL: " << g.read(m.total) << std::endl;
+    std::cout << "SPFM:  " << g.spfm(m.asil) << "%" << std::endl;
+    std::cout << "LFM:   " << g.lfm(m.asil) << "%" << std::endl;
+    std::cout << "ASIL:  " << g.asil_level(m.asil) << std::endl;
+    std::cout << "Nodes: " << g.size() << " Values: " << g.values() << " Levels: " << g.levels()
+              << " Memory: " << g.memory_bytes() << " bytes"
+              << " Time: " << std::chrono::duration<double, std::micro>(end - start).count() << " us" << std::endl;
+
+    return 0;
+}
@@ -35,8 +35,13 @@
  */
 
 #include <sc_hw_metrics.h>
+#include <sc_hw_markov.h>
+#include <sc_columnar_trace.h>
+#include <sc_memory_report.h>
 
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <systemc>
 
 using namespace sc_hw_metrics;
@@ -481,16 +486,46 @@ int sc_main(int argc, char *argv[])
     sum latent("LATENT");
     asil calculate_asil("ASIL", TOTAL);
 
+    // PMHF for a lifetime of 10000 h and 15000 h, and without start-up tests
+    double STARTUP_TEST = 1.0; // hours between start-up tests (one drive cycle)
+    pmhf calculate_pmhf("PMHF", TOTAL, {{10000.0, {}}, {15000.0, {}}, {10000.0, std::vector<double>(10, 0.0)}});
+
     // DRAM
     sc_signal<double> dram_res_sbe("dram_res_sbe");
     sc_signal<double> dram_res_dbe("dram_res_dbe");
     sc_signal<double> dram_res_mbe("dram_res_mbe");
     sc_signal<double> dram_res_wd("dram_res_wd");
 
-    dram.SBE.bind(dram_res_sbe);
-    dram.DBE.bind(dram_res_dbe);
-    dram.MBE.bind(dram_res_mbe);
-    dram.WD.bind(dram_res_wd);
+    // Optional SBE accumulation between patrol scrubs of an 8 Gbit device,
+    // e.g. SCRUB_INTERVAL=24 (hours). DRAM then gives the raw fault rates.
+    std::unique_ptr<sc_hw_markov::scrubbed_memory> scrubbing;
+    sc_signal<double> dram_raw_sbe("dram_raw_sbe");
+    sc_signal<double> dram_raw_dbe("dram_raw_dbe");
+    sc_signal<double> dram_raw_mbe("dram_raw_mbe");
+    sc_signal<double> dram_raw_wd("dram_raw_wd");
+
+    if (const char* interval = std::getenv("SCRUB_INTERVAL")) {
+        scrubbing = std::make_unique<sc_hw_markov::scrubbed_memory>("SCRUBBING", std::stod(interval), 8.0 * (1ull << 30));
+
+        dram.SBE.bind(dram_raw_sbe);
+        dram.DBE.bind(dram_raw_dbe);
+        dram.MBE.bind(dram_raw_mbe);
+        dram.WD.bind(dram_raw_wd);
+
+        scrubbing->sbe_rate.bind(dram_raw_sbe);
+        scrubbing->dbe_rate.bind(dram_raw_dbe);
+        scrubbing->mbe_rate.bind(dram_raw_mbe);
+        scrubbing->wd_rate.bind(dram_raw_wd);
+        scrubbing->sbe.bind(dram_res_sbe);
+        scrubbing->dbe.bind(dram_res_dbe);
+        scrubbing->mbe.bind(dram_res_mbe);
+        scrubbing->wd.bind(dram_res_wd);
+    } else {
+        dram.SBE.bind(dram_res_sbe);
+        dram.DBE.bind(dram_res_dbe);
+        dram.MBE.bind(dram_res_mbe);
+        dram.WD.bind(dram_res_wd);
+    }
 
     // SEC-ECC
     sec_ecc.I_SBE.bind(dram_res_sbe);
@@ -648,8 +683,48 @@ int sc_main(int argc, char *argv[])
     calculate_asil.residual.bind(residual_result);
     calculate_asil.latent.bind(latent_result);
 
+    calculate_pmhf.residual.bind(residual_result);
+    calculate_pmhf.latent.bind(sec_ecc_lat_sbe, 0.0);
+    calculate_pmhf.latent.bind(sec_ecc_lat_sec_broken, 0.0);
+    calculate_pmhf.latent.bind(sec_ded_lat_sbe, 0.0);
+    calculate_pmhf.latent.bind(sec_ded_lat_dbe, 0.0);
+    calculate_pmhf.latent.bind(sec_ded_lat_tbe, 0.0);
+    calculate_pmhf.latent.bind(sec_ded_lat_mbe, 0.0);
+    calculate_pmhf.latent.bind(sec_ded_lat_sec_ded_broken, STARTUP_TEST);
+    calculate_pmhf.latent.bind(bus_trim_lat_if, 0.0);
+    calculate_pmhf.latent.bind(bus_trim_lat_lb, STARTUP_TEST);
+    calculate_pmhf.latent.bind(all_other_components_lat, 0.0);
+
+    // Optional memory report after elaboration, e.g. MEMORY_REPORT=memory.csv
+    std::unique_ptr<sc_memory_report::memory_report> memory;
+
+    if (const char* path = std::getenv("MEMORY_REPORT")) {
+        memory = std::make_unique<sc_memory_report::memory_report>("MEMORY_REPORT", path);
+        memory->register_type<DRAM>();
+        memory->register_type<DRAM_SEC_ECC>();
+        memory->register_type<DRAM_SEC_TRIM>();
+        memory->register_type<DRAM_BUS_TRIM>();
+        memory->register_type<DRAM_SEC_DED>();
+        memory->register_type<DRAM_SEC_DED_TRIM>();
+        memory->register_type<ALL_OTHER_COMPONENTS>();
+        memory->register_type<sc_hw_markov::scrubbed_memory>();
+    }
+
+    // Optional columnar trace of all signals, appended as one row per run
+    std::unique_ptr<sc_columnar_trace::trace_file> trace;
+
+    if (argc > 2) {
+        trace = std::make_unique<sc_columnar_trace::trace_file>(argv[2]);
+        trace->trace(DRAM_FIT, "DRAM_FIT");
+        trace->trace_all();
+    }
+
     sc_start();
 
+    if (trace) {
+        trace->sample();
+    }
+
     std::cout << "DRAM: RES_SBE: " << dram_res_sbe << std::endl;
     std::cout << "DRAM: RES_DBE: " << dram_res_dbe << std::endl;
     std::cout << "DRAM: RES_MBE: " << dram_res_mbe << std::endl;
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include <sc_hw_stage.h>
+#include <sc_hw_metrics.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_stage;
+
+// Same model as dram-metrics-refactored with every ECC stage as a transfer
+// stage. The chain is composed once, each DRAM_FIT is then evaluated with
+// one matrix-vector product. A second argument evaluates that many DRAM_FIT
+// values from 0 to the first argument to measure the evaluation time.
+
+int sc_main(int argc, char *argv[])
+{
+    double DRAM_FIT = (argc > 1) ? std::stod(argv[1]) : 2300.0;
+    long POINTS = (argc > 2) ? std::stol(argv[2]) : 0;
+    double OTHER_COMPONENTS = 1900.0;
+
+    error_vector dram = {0.7, 0.0748, 0.0, 0.0748, 0.0748, 0.0748};
+
+    stage sec_ecc = stage("DRAM_SEC_ECC")
+        .route(SBE, SBE, 1.0, 1.0, 0.0)
+        .route(DBE, DBE, 0.83)
+        .route(DBE, TBE, 0.17)
+        .pass(TBE).pass(MBE).pass(WD).pass(AZ)
+        .latent_event(0.1);
+
+    stage sec_trim = stage("DRAM_SEC_TRIM")
+        .route(SBE, SBE, 0.94)
+        .route(DBE, SBE, 0.11).route(DBE, DBE, 0.89)
+        .route(TBE, SBE, 0.009).route(TBE, DBE, 0.15).route(TBE, TBE, 0.83)
+        .pass(MBE).pass(WD).pass(AZ);
+
+    stage bus_trim = stage("DRAM_BUS_TRIM")
+        .route(SBE, SBE, 0.438)
+        .route(DBE, SBE, 0.496).route(DBE, DBE, 0.314)
+        .route(TBE, SBE, 0.325).route(TBE, DBE, 0.419).route(TBE, TBE, 0.175)
+        .pass(MBE).pass(WD).pass(AZ)
+        .inject(MBE, 5e9, 1.0, 1.0)
+        .latent_event(0.1);
+
+    stage sec_ded = stage("DRAM_SEC_DED")
+        .route(SBE, SBE, 1.0, 1.0, 1.0)
+        .route(DBE, DBE, 1.0, 1.0, 1.0)
+        .route(TBE, TBE, 0.44, 1.0, 1.0).route(TBE, MBE, 0.56)
+        .route(MBE, MBE, 1.0, 0.5, 0.5)
+        .pass(WD).pass(AZ)
+        .latent_event(0.1);
+
+    stage sec_ded_trim = stage("DRAM_SEC_DED_TRIM")
+        .route(SBE, SBE, 0.89)
+        .route(DBE, SBE, 0.20).route(DBE, DBE, 0.79)
+        .route(TBE, SBE, 0.03).route(TBE, DBE, 0.27).route(TBE, TBE, 0.70)
+        .pass(MBE).pass(WD).pass(AZ);
+
+    stage pipeline = chain({sec_ecc, sec_trim, bus_trim, sec_ded, sec_ded_trim, stage::sink()});
+
+    // Other: half of the FIT is safety related and covered
+    double other_residual = 0.5 * (1 - 0.99) * OTHER_COMPONENTS;
+    double other_latent = 0.5 * (1 - 1.0) * OTHER_COMPONENTS;
+
+    auto metrics = [&](double fit, double& res, double& lat, double& total) {
+        error_vector input;
+        for (std::size_t c = 0; c < error_classes; c++) {
+            input[c] = dram[c] * fit;
+        }
+        result r = pipeline.evaluate(input);
+        res = r.residual + other_residual;
+        lat = r.latent + other_latent;
+        total = fit + OTHER_COMPONENTS;
+    };
+
+    double res, lat, total;
+    metrics(DRAM_FIT, res, lat, total);
+
+    double spfm = 100 * (1 - (res / total));
+    double lfm = 100 * (1 - (lat / (total - res)));
+
+    std::cout << pipeline;
+    std::cout << "------------------------------ " << std::endl;
+    std::cout << "RES:   " << res << std::endl;
+    std::cout << "LAT:   " << lat << std::endl;
+    std::cout << "TOTAL: " << total << std::endl;
+    std::cout << "SPFM:  " << spfm << "%" << std::endl;
+    std::cout << "LFM:   " << lfm << "%" << std::endl;
+    std::cout << "ASIL:  " << sc_hw_metrics::asil_levels[sc_hw_metrics::asil_class(spfm, lfm, res)] << std::endl;
+
+    if (POINTS > 0) {
+        double checksum = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < POINTS; i++) {
+            metrics(DRAM_FIT * i / POINTS, res, lat, total);
+            checksum += res + lat;
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Points: " << POINTS << " Time: "
+                  << std::chrono::duration<double, std::nano>(end - start).count() / POINTS << " ns/point"
+                  << " (checksum " << checksum << ")" << std::endl;
+    }
+
+    return 0;
+}
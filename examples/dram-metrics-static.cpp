@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include <sc_hw_static.h>
+
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_static;
+
+// Same model as dram-metrics-refactored with all constants fixed at compile
+// time. Only DRAM_FIT is a runtime value, the whole model folds into two
+// coefficients per result.
+
+namespace dram {
+
+    using FIT = input;
+
+    // DRAM
+    using DRAM = split<FIT, 0.7, 0.0748, 0.0748, 0.0748, 0.0748>;
+    using SBE = output<DRAM, 0>;
+    using DBE = output<DRAM, 1>;
+    using MBE = output<DRAM, 2>;
+    using WD = output<DRAM, 3>;
+    using AZ = output<DRAM, 4>;
+
+    // SEC-ECC
+    using SEC_Coverage = coverage<SBE, 1.0, 0.0>;
+    using SEC_split = split<DBE, 0.83, 0.17>;
+    using SEC_BROKEN = basic_event<0.1>;
+
+    // DRAM-TRIM
+    using T_SBE = split<SEC_Coverage, 0.94>;
+    using T_DBE = split<output<SEC_split, 0>, 0.11, 0.89>;
+    using T_TBE = split<output<SEC_split, 1>, 0.009, 0.15, 0.83>;
+    using T_SBE_SUM = sum<output<T_SBE, 0>, output<T_DBE, 0>, output<T_TBE, 0>>;
+    using T_DBE_SUM = sum<output<T_DBE, 1>, output<T_TBE, 1>>;
+
+    // BUS-TRIM
+    using B_SBE = split<T_SBE_SUM, 0.438>;
+    using B_DBE = split<T_DBE_SUM, 0.496, 0.314>;
+    using B_TBE = split<output<T_TBE, 2>, 0.325, 0.419, 0.175>;
+    using B_SBE_SUM = sum<output<B_SBE, 0>, output<B_DBE, 0>, output<B_TBE, 0>>;
+    using B_DBE_SUM = sum<output<B_DBE, 1>, output<B_TBE, 1>>;
+    using IF_SBE = basic_event<5e9>;
+    using IF_SBE_COVERAGE = coverage<IF_SBE, 1.0, 1.0>;
+    using LINK_ECC_BROKEN = basic_event<0.1>;
+    using B_MBE_SUM = sum<MBE, IF_SBE_COVERAGE>;
+
+    // SEC-DED
+    using D_SBE = coverage<B_SBE_SUM, 1.0, 1.0>;
+    using D_DBE = coverage<B_DBE_SUM, 1.0, 1.0>;
+    using D_TBE_SPLIT = split<output<B_TBE, 2>, 0.44, 0.56>;
+    using D_TBE = coverage<output<D_TBE_SPLIT, 0>, 1.0, 1.0>;
+    using D_MBE = coverage<B_MBE_SUM, 0.5, 0.5>;
+    using SEC_DED_BROKEN = basic_event<0.1>;
+    using D_MBE_SUM = sum<output<D_TBE_SPLIT, 1>, D_MBE>;
+
+    // SEC-DED-TRIM
+    using DT_SBE = split<D_SBE, 0.89>;
+    using DT_DBE = split<D_DBE, 0.20, 0.79>;
+    using DT_TBE = split<D_TBE, 0.03, 0.27, 0.70>;
+    using DT_SBE_SUM = sum<output<DT_SBE, 0>, output<DT_DBE, 0>, output<DT_TBE, 0>>;
+    using DT_DBE_SUM = sum<output<DT_DBE, 1>, output<DT_TBE, 1>>;
+
+    // Other
+    using ALL_OTHER = basic_event<1900.0>;
+    using OTHER_SPLIT = split<ALL_OTHER, 0.5>;
+    using OTHER_COV = coverage<output<OTHER_SPLIT, 0>, 0.99, 1.0>;
+
+    // ASIL
+    using RESIDUAL = sum<DT_SBE_SUM, DT_DBE_SUM, output<DT_TBE, 2>, D_MBE_SUM, WD, AZ, OTHER_COV>;
+    using LATENT = sum<latent<SEC_Coverage>, SEC_BROKEN, latent<IF_SBE_COVERAGE>, LINK_ECC_BROKEN,
+                       latent<D_SBE>, latent<D_DBE>, latent<D_TBE>, latent<D_MBE>, SEC_DED_BROKEN,
+                       latent<OTHER_COV>>;
+    using TOTAL = sum<FIT, ALL_OTHER>;
+
+    using ASIL = asil<RESIDUAL, LATENT, TOTAL>;
+}
+
+// The default configuration is checked while compiling
+static_assert(dram::ASIL::evaluate(2300.0).asil_class >= 1, "DRAM model below ASIL-A");
+
+int sc_main(int argc, char *argv[])
+{
+    double DRAM_FIT = (argc == 1) ? 2300.0 : std::stod(argv[1]);
+
+    metrics m = dram::ASIL::evaluate(DRAM_FIT);
+
+    std::cout << "RES:   " << m.residual << " = " << dram::ASIL::residual.a << " * DRAM_FIT + " << dram::ASIL::residual.b << std::endl;
+    std::cout << "LAT:   " << m.latent << " = " << dram::ASIL::latent.a << " * DRAM_FIT + " << dram::ASIL::latent.b << std::endl;
+    std::cout << "TOTAL: " << m.total << std::endl;
+    std::cout << "SPFM:  " << m.spfm << "%" << std::endl;
+    std::cout << "LFM:   " << m.lfm << "%" << std::endl;
+    std::cout << "ASIL:  " << sc_hw_metrics::asil_levels[m.asil_class] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <systemc>
+#include <vector>
+
+using namespace sc_hw_graph;
+
+// Evaluates many independent scenarios of the DRAM model of
+// dram-metrics-graph concurrently: DRAM_FIT from 10 to 1e4 FIT crossed with
+// the MBE coverage of SEC-DED from 0 to 0.99. The model is built once and
+// every task evaluates its scenarios on its own instance. Arguments: number
+// of scenarios (default 100000) and number of threads.
+
+int sc_main(int argc, char *argv[])
+{
+    std::size_t SCENARIOS = (argc > 1) ? std::stoul(argv[1]) : 100000;
+    unsigned THREADS = (argc > 2) ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+    double OTHER_COMPONENTS = 1900.0;
+
+    graph g;
+    dram_model m = build_dram_model(g, 2300.0, OTHER_COMPONENTS, dram_parameters<double>());
+    g.compile();
+
+    node_id dram_fit = g.find("DRAM_FIT");
+    node_id mbe_cov = g.find("DRAM_SEC_DED.RES_MBE_COV");
+    std::size_t side = std::max<std::size_t>(std::sqrt(double(SCENARIOS)), 1);
+
+    std::vector<double> spfm(SCENARIOS);
+    std::vector<int> levels(SCENARIOS);
+    sc_parallel::thread_pool pool(THREADS);
+
+    auto start = std::chrono::steady_clock::now();
+
+    pool.parallel_for(0, SCENARIOS, 1024, [&](std::size_t first, std::size_t last) {
+        instance s(g);
+
+        for (std::size_t i = first; i < last; i++) {
+            s.set_coefficient(dram_fit, 0, std::pow(10.0, 1.0 + 3.0 * (i / side) / double(side)));
+            s.set_coefficient(mbe_cov, 0, 0.99 * (i % side) / double(side));
+            s.evaluate();
+
+            spfm[i] = s.spfm(m.asil);
+            levels[i] = s.asil_class(m.asil);
+        }
+    });
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<std::size_t> histogram(5, 0);
+    for (int l : levels) {
+        histogram[l]++;
+    }
+
+    std::cout << "Scenarios: " << SCENARIOS << " Threads: " << pool.size()
+              << " Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    for (int l = 0; l < 5; l++) {
+        std::cout << sc_hw_metrics::asil_levels[l] << ": " << histogram[l] << std::endl;
+    }
+
+    return 0;
+}
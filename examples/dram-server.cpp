@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_server.h>
+
+#include <iostream>
+#include <string>
+#include <systemc>
+
+// The graph model of dram-metrics-graph as a server: it is built once and
+// then answers requests like "DRAM_FIT=2300 SEC[0]=0.99" from stdin or, if
+// a path is given, from the clients of a UNIX socket at that path:
+//
+//   echo "DRAM_FIT=1000" | dram-server
+//   dram-server /tmp/dram.sock &
+//   printf 'DRAM_FIT=1000\nquit\n' | nc -U /tmp/dram.sock
+
+int sc_main(int argc, char *argv[])
+{
+    double DRAM_FIT = 2300.0;
+    double OTHER_COMPONENTS = 1900.0;
+
+    sc_hw_graph::graph g;
+    dram_model m = build_dram_model(g, DRAM_FIT, OTHER_COMPONENTS, dram_parameters<double>());
+    g.compile();
+
+    sc_hw_server::graph_server server(g, m.asil);
+
+    if (argc > 1) {
+        std::cerr << "Listening on " << argv[1] << std::endl;
+        server.serve_socket(argv[1]);
+    } else {
+        server.serve_stdio();
+    }
+
+    std::cerr << "Served " << server.requests() << " requests" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_solve.h>
+
+#include <iostream>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_solve;
+
+// Minimal coverage of single mechanisms of the DRAM model for a target ASIL
+// (default ASIL-D), all other coefficients as in dram-metrics-refactored.
+// Arguments: target ASIL and DRAM_FIT.
+
+int sc_main(int argc, char *argv[])
+{
+    std::string TARGET = (argc > 1) ? argv[1] : "ASIL-D";
+    double DRAM_FIT = (argc > 2) ? std::stod(argv[2]) : 2300.0;
+    double OTHER_COMPONENTS = 1900.0;
+
+    int target = sc_hw_metrics::asil_index(TARGET);
+    if (target < 0) {
+        SC_REPORT_FATAL("SOLVE", ("Unknown ASIL level " + TARGET).c_str());
+    }
+
+    graph g;
+    build_dram_model(g, DRAM_FIT, OTHER_COMPONENTS, dram_parameters<double>());
+    solver s(g, "ASIL");
+
+    std::vector<std::pair<std::string, unknown>> unknowns = {
+        {"RES_MBE_COV dc+lc", {{{"DRAM_SEC_DED.RES_MBE_COV", 0}, {"DRAM_SEC_DED.RES_MBE_COV", 1}}, 0.5, 1.0}},
+        {"OTHER_COV dc", {{{"ALL_OTHER_COMPONENTS.OTHER_COV", 0}}, 0.99, 1.0}},
+        {"OTHER_COV lc", {{{"ALL_OTHER_COMPONENTS.OTHER_COV", 1}}, 0.0, 1.0}},
+        {"SEC_Coverage lc", {{{"DRAM_SEC_ECC.SEC_Coverage", 1}}, 0.0, 1.0}},
+        {"DRAM WD share (max)", {{{"DRAM", 3}}, 0.0748, 0.0}},
+        {"DRAM AZ share (max)", {{{"DRAM", 4}}, 0.0748, 0.0}}
+    };
+
+    std::cout << "Target: " << TARGET << std::endl;
+    std::cout << "unknown,feasible,value,limiting,evaluations,spfm,lfm,residual" << std::endl;
+
+    for (auto& [name, u] : unknowns) {
+        solution r = s.solve(u, target);
+        std::cout << name << "," << r.feasible << "," << r.value << "," << r.limiting << "," << r.evaluations << ","
+                  << r.spfm << "," << r.lfm << "," << r.residual << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_hw_stochastic.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <systemc>
+#include <thread>
+
+using namespace sc_hw_graph;
+
+// Checks the analytic residual and latent rates of the DRAM model of
+// dram-metrics-graph by simulating fault arrivals. Arguments: simulated
+// hours per replica (default 1e12), number of replicas (default 64) and
+// number of threads.
+
+int sc_main(int argc, char *argv[])
+{
+    double HOURS = (argc > 1) ? std::stod(argv[1]) : 1e12;
+    std::size_t REPLICAS = (argc > 2) ? std::stoul(argv[2]) : 64;
+    unsigned THREADS = (argc > 3) ? std::stoul(argv[3]) : std::thread::hardware_concurrency();
+
+    graph g;
+    dram_model m = build_dram_model(g, 2300.0, 1900.0, dram_parameters<double>());
+    g.compile();
+
+    sc_hw_stochastic::options o;
+    o.hours = HOURS;
+    o.replicas = REPLICAS;
+
+    sc_parallel::thread_pool pool(THREADS);
+
+    auto start = std::chrono::steady_clock::now();
+    auto estimates = sc_hw_stochastic::simulate(g, {m.residual, m.latent}, o, pool);
+    auto end = std::chrono::steady_clock::now();
+
+    const char* names[] = {"RES:", "LAT:"};
+    for (std::size_t i = 0; i < estimates.size(); i++) {
+        std::cout << names[i] << " " << estimates[i]
+                  << (estimates[i].covers_analytic() ? "" : " outside the interval") << std::endl;
+    }
+
+    std::cout << "Hours: " << HOURS << " x " << REPLICAS << " Threads: " << pool.size()
+              << " Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    return 0;
+}
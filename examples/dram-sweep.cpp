@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#include "dram-graph-model.h"
+
+#include <sc_arrow_ipc.h>
+#include <sc_hw_cache.h>
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <systemc>
+
+using namespace sc_hw_graph;
+
+// Sweeps DRAM_FIT logarithmically from 1e-2 to 1e4 FIT over the graph model
+// of dram-metrics-graph and writes one row per point to an Arrow IPC file.
+// Arguments: output file (default results.arrow), number of points
+// (default 20) and optionally a result cache file that is reused by the next
+// run, so repeated sweeps only evaluate new points.
+
+int sc_main(int argc, char *argv[])
+{
+    std::string OUTPUT = (argc > 1) ? argv[1] : "results.arrow";
+    std::int64_t POINTS = (argc > 2) ? std::stoll(argv[2]) : 20;
+    double OTHER_COMPONENTS = 1900.0;
+
+    graph g;
+    dram_model m = build_dram_model(g, 1.0, OTHER_COMPONENTS, dram_parameters<double>());
+    g.compile();
+    node_id dram_fit_node = g.find("DRAM_FIT");
+
+    std::unique_ptr<sc_hw_cache::store> store;
+    std::unique_ptr<sc_hw_cache::cached_graph> cache;
+    sc_hw_cache::statistics total;
+
+    if (argc > 3) {
+        store = std::make_unique<sc_hw_cache::store>(argv[3]);
+        cache = std::make_unique<sc_hw_cache::cached_graph>(g, *store);
+    }
+
+    double dram_fit, res, lat, spfm, lfm;
+    std::int64_t point;
+    std::string asil;
+
+    sc_arrow_ipc::file_writer out(OUTPUT);
+    out.column(point, "point");
+    out.column(dram_fit, "dram_fit");
+    out.column(res, "res");
+    out.column(lat, "lat");
+    out.column(spfm, "spfm");
+    out.column(lfm, "lfm");
+    out.column(asil, "asil");
+
+    for (point = 0; point < POINTS; point++) {
+        dram_fit = std::pow(10.0, -2.0 + 6.0 * point / std::max<std::int64_t>(POINTS - 1, 1));
+        if (cache) {
+            cache->set_coefficient(dram_fit_node, 0, dram_fit);
+            auto s = cache->evaluate({m.residual, m.latent, g.output(m.asil, 0), g.output(m.asil, 1)});
+            total.evaluated += s.evaluated;
+            total.loaded += s.loaded;
+            total.skipped += s.skipped;
+        } else {
+            g.set_coefficient(dram_fit_node, 0, dram_fit);
+            g.evaluate();
+        }
+
+        res = g.read(m.residual);
+        lat = g.read(m.latent);
+        spfm = g.spfm(m.asil);
+        lfm = g.lfm(m.asil);
+        asil = g.asil_level(m.asil);
+        out.sample();
+    }
+
+    out.close();
+    std::cout << "Wrote " << POINTS << " points to " << OUTPUT << std::endl;
+
+    if (cache) {
+        std::cout << "Cache: " << total.evaluated << " nodes evaluated, " << total.loaded << " loaded, "
+                  << total.skipped << " skipped" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,821 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "../sc_hw_graph.h"
+#include "../examples/dram-graph-model.h"
+
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace sc_hw_graph;
+
+// Python bindings of the graph backend, written against the CPython API so
+// that they need nothing but the Python headers. Models are built with the
+// same primitives as in C++ (basic_event, coverage, split, sum, pass_, asil)
+// or loaded with dram_model(), then evaluated in batch for a 2-D float64
+// array (e.g. NumPy) of parameter sets. Values and nodes are plain integers,
+// results are memoryviews of doubles that own their data. SystemC errors are
+// raised as RuntimeError instead of aborting the interpreter. A graph must
+// not be used by two threads at once.
+//
+//   import numpy as np, iso26262systemc as iso
+//   g = iso.dram_model()
+//   r = g.evaluate_batch(g.find("ASIL"), [("DRAM_FIT", 0)], fits.reshape(-1, 1))
+//   np.asarray(r["spfm"]), r["lfm"], r["residual"], r["latent"]
+
+// SystemC libraries refer to sc_main, the module never starts a simulation
+int sc_main(int, char**)
+{
+    return 0;
+}
+
+namespace {
+
+    struct py_graph
+    {
+        PyObject_HEAD
+        graph* g;
+    };
+
+    // Runs f and turns C++ and SystemC errors into Python exceptions
+    template <class F>
+    PyObject* guarded(F f)
+    {
+        try {
+            return f();
+        } catch (const std::bad_alloc&) {
+            return PyErr_NoMemory();
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+            return nullptr;
+        }
+    }
+
+    // Runs f without the GIL, errors are rethrown with the GIL held
+    template <class F>
+    void without_gil(F f)
+    {
+        std::exception_ptr error;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            f();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        Py_END_ALLOW_THREADS
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Copies n doubles into a bytearray and returns a memoryview of it
+    PyObject* doubles(const double* data, std::size_t n)
+    {
+        PyObject* bytes = PyByteArray_FromStringAndSize(nullptr, Py_ssize_t(n * sizeof(double)));
+        if (bytes == nullptr) {
+            return nullptr;
+        }
+        if (n != 0) {
+            std::memcpy(PyByteArray_AS_STRING(bytes), data, n * sizeof(double));
+        }
+        PyObject* view = PyMemoryView_FromObject(bytes);
+        Py_DECREF(bytes);
+        if (view == nullptr) {
+            return nullptr;
+        }
+        PyObject* typed = PyObject_CallMethod(view, "cast", "s", "d");
+        Py_DECREF(view);
+        return typed;
+    }
+
+    PyObject* values_list(const std::vector<value>& values)
+    {
+        PyObject* list = PyList_New(Py_ssize_t(values.size()));
+        if (list == nullptr) {
+            return nullptr;
+        }
+        for (std::size_t i = 0; i < values.size(); i++) {
+            PyObject* id = PyLong_FromUnsignedLong(values[i].id);
+            if (id == nullptr) {
+                Py_DECREF(list);
+                return nullptr;
+            }
+            PyList_SET_ITEM(list, Py_ssize_t(i), id);
+        }
+        return list;
+    }
+
+    // Checks of the arguments, false with a Python exception set
+
+    bool building(const graph& g)
+    {
+        if (g.compiled()) {
+            PyErr_SetString(PyExc_RuntimeError, "the graph is compiled, its structure is fixed");
+            return false;
+        }
+        return true;
+    }
+
+    bool valid_value(const graph& g, unsigned int v)
+    {
+        if (v >= g.values()) {
+            PyErr_Format(PyExc_IndexError, "no value %u", v);
+            return false;
+        }
+        return true;
+    }
+
+    bool valid_node(const graph& g, unsigned int n)
+    {
+        if (n >= g.size()) {
+            PyErr_Format(PyExc_IndexError, "no node %u", n);
+            return false;
+        }
+        return true;
+    }
+
+    bool valid_asil(const graph& g, unsigned int n)
+    {
+        if (!valid_node(g, n)) {
+            return false;
+        }
+        if (g.node_kind(n) != kind::asil) {
+            PyErr_Format(PyExc_ValueError, "node %u is not an asil node", n);
+            return false;
+        }
+        return true;
+    }
+
+    bool valid_coefficient(const graph& g, unsigned int n, Py_ssize_t k)
+    {
+        if (!valid_node(g, n)) {
+            return false;
+        }
+        if (k < 0 || std::size_t(k) >= g.coefficient_count(n)) {
+            PyErr_Format(PyExc_IndexError, "node %u has no coefficient %zd", n, k);
+            return false;
+        }
+        return true;
+    }
+
+    // Native doubles, as NumPy float64 arrays export them
+    bool double_format(const char* format)
+    {
+        if (format == nullptr) {
+            return false;
+        }
+        if (format[0] == '@' || format[0] == '=') {
+            format++;
+        }
+        return std::strcmp(format, "d") == 0;
+    }
+
+    bool doubles_of(PyObject* sequence, std::vector<double>& out, const char* what)
+    {
+        PyObject* fast = PySequence_Fast(sequence, what);
+        if (fast == nullptr) {
+            return false;
+        }
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(fast); i++) {
+            double x = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(fast, i));
+            if (x == -1.0 && PyErr_Occurred()) {
+                Py_DECREF(fast);
+                return false;
+            }
+            out.push_back(x);
+        }
+        Py_DECREF(fast);
+        return true;
+    }
+
+    bool values_of(const graph& g, PyObject* sequence, std::vector<value>& out)
+    {
+        PyObject* fast = PySequence_Fast(sequence, "inputs must be a sequence of values");
+        if (fast == nullptr) {
+            return false;
+        }
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(fast); i++) {
+            unsigned long v = PyLong_AsUnsignedLong(PySequence_Fast_GET_ITEM(fast, i));
+            if ((v == static_cast<unsigned long>(-1) && PyErr_Occurred()) || !valid_value(g, v)) {
+                Py_DECREF(fast);
+                return false;
+            }
+            out.push_back(value{static_cast<std::uint32_t>(v)});
+        }
+        Py_DECREF(fast);
+        return true;
+    }
+}
+
+// Graph type
+
+namespace {
+
+    PyObject* graph_new(PyTypeObject* type, PyObject*, PyObject*)
+    {
+        py_graph* self = reinterpret_cast<py_graph*>(type->tp_alloc(type, 0));
+        if (self == nullptr) {
+            return nullptr;
+        }
+        self->g = new (std::nothrow) graph();
+        if (self->g == nullptr) {
+            Py_DECREF(self);
+            return PyErr_NoMemory();
+        }
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    void graph_dealloc(PyObject* object)
+    {
+        PyTypeObject* type = Py_TYPE(object);
+        delete reinterpret_cast<py_graph*>(object)->g;
+        type->tp_free(object);
+        Py_DECREF(type);
+    }
+
+    graph& of(PyObject* self)
+    {
+        return *reinterpret_cast<py_graph*>(self)->g;
+    }
+
+    // Builder
+
+    PyObject* graph_basic_event(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "rate", nullptr};
+        const char* name;
+        double rate;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sd", const_cast<char**>(kw), &name, &rate)
+            || !building(of(self))) {
+            return nullptr;
+        }
+        return guarded([&]() { return PyLong_FromUnsignedLong(of(self).basic_event(name, rate).id); });
+    }
+
+    PyObject* graph_coverage(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "input", "dc", "lc", nullptr};
+        const char* name;
+        unsigned int input;
+        double dc, lc;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sIdd", const_cast<char**>(kw), &name, &input, &dc, &lc)
+            || !building(of(self)) || !valid_value(of(self), input)) {
+            return nullptr;
+        }
+        if (!(dc >= 0.0 && dc <= 1.0 && lc >= 0.0 && lc <= 1.0)) {
+            PyErr_SetString(PyExc_ValueError, "dc and lc must be in [0, 1]");
+            return nullptr;
+        }
+        return guarded([&]() {
+            coverage_outputs c = of(self).coverage(name, value{input}, dc, lc);
+            return Py_BuildValue("(kk)", static_cast<unsigned long>(c.output.id),
+                                 static_cast<unsigned long>(c.latent.id));
+        });
+    }
+
+    PyObject* graph_split(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "input", "rates", nullptr};
+        const char* name;
+        unsigned int input;
+        PyObject* sequence;
+        std::vector<double> rates;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sIO", const_cast<char**>(kw), &name, &input, &sequence)
+            || !building(of(self)) || !valid_value(of(self), input)
+            || !doubles_of(sequence, rates, "rates must be a sequence of numbers")) {
+            return nullptr;
+        }
+        return guarded([&]() { return values_list(of(self).split(name, value{input}, rates)); });
+    }
+
+    PyObject* graph_sum(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "inputs", nullptr};
+        const char* name;
+        PyObject* sequence;
+        std::vector<value> inputs;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO", const_cast<char**>(kw), &name, &sequence)
+            || !building(of(self)) || !values_of(of(self), sequence, inputs)) {
+            return nullptr;
+        }
+        if (inputs.empty()) {
+            PyErr_SetString(PyExc_ValueError, "a sum needs at least one input");
+            return nullptr;
+        }
+        return guarded([&]() { return PyLong_FromUnsignedLong(of(self).sum(name, inputs).id); });
+    }
+
+    PyObject* graph_pass(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "input", nullptr};
+        const char* name;
+        unsigned int input;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sI", const_cast<char**>(kw), &name, &input)
+            || !building(of(self)) || !valid_value(of(self), input)) {
+            return nullptr;
+        }
+        return guarded([&]() { return PyLong_FromUnsignedLong(of(self).pass(name, value{input}).id); });
+    }
+
+    PyObject* graph_asil(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"name", "residual", "latent", "total", nullptr};
+        const char* name;
+        unsigned int residual, latent, total;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sIII", const_cast<char**>(kw),
+                                         &name, &residual, &latent, &total)
+            || !building(of(self)) || !valid_value(of(self), residual) || !valid_value(of(self), latent)
+            || !valid_value(of(self), total)) {
+            return nullptr;
+        }
+        return guarded([&]() {
+            return PyLong_FromUnsignedLong(of(self).asil(name, value{residual}, value{latent}, value{total}));
+        });
+    }
+
+    PyObject* graph_compile(PyObject* self, PyObject*)
+    {
+        return guarded([&]() {
+            of(self).compile();
+            Py_RETURN_NONE;
+        });
+    }
+
+    // Evaluation, every query compiles the graph first
+
+    PyObject* graph_evaluate(PyObject* self, PyObject*)
+    {
+        return guarded([&]() {
+            graph& g = of(self);
+            without_gil([&g]() { g.evaluate(); });
+            Py_RETURN_NONE;
+        });
+    }
+
+    PyObject* graph_read(PyObject* self, PyObject* args)
+    {
+        unsigned int v;
+        if (!PyArg_ParseTuple(args, "I", &v)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_value(g, v)) {
+                return nullptr;
+            }
+            return PyFloat_FromDouble(g.read(value{v}));
+        });
+    }
+
+    // Applies f to a checked asil node of the compiled graph
+    template <class F>
+    PyObject* asil_query(PyObject* self, PyObject* args, F f)
+    {
+        unsigned int n;
+        if (!PyArg_ParseTuple(args, "I", &n)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_asil(g, n)) {
+                return nullptr;
+            }
+            return f(g, n);
+        });
+    }
+
+    PyObject* graph_spfm(PyObject* self, PyObject* args)
+    {
+        return asil_query(self, args, [](graph& g, node_id n) { return PyFloat_FromDouble(g.spfm(n)); });
+    }
+
+    PyObject* graph_lfm(PyObject* self, PyObject* args)
+    {
+        return asil_query(self, args, [](graph& g, node_id n) { return PyFloat_FromDouble(g.lfm(n)); });
+    }
+
+    PyObject* graph_asil_level(PyObject* self, PyObject* args)
+    {
+        return asil_query(self, args, [](graph& g, node_id n) {
+            return PyUnicode_FromString(g.asil_level(n).c_str());
+        });
+    }
+
+    PyObject* graph_asil_class(PyObject* self, PyObject* args)
+    {
+        return asil_query(self, args, [](graph& g, node_id n) { return PyLong_FromLong(g.asil_class(n)); });
+    }
+
+    // Copy of all node outputs, indexed by value
+    PyObject* graph_outputs(PyObject* self, PyObject*)
+    {
+        return guarded([&]() {
+            graph& g = of(self);
+            g.compile();
+            return doubles(g.data(), g.values());
+        });
+    }
+
+    // One evaluation per row of values, each column sets one
+    // (node name, coefficient index) parameter
+    PyObject* graph_evaluate_batch(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"asil", "parameters", "values", nullptr};
+        unsigned int asil;
+        PyObject* names;
+        PyObject* array;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "IOO", const_cast<char**>(kw), &asil, &names, &array)) {
+            return nullptr;
+        }
+
+        graph& g = of(self);
+        PyObject* compiled = graph_compile(self, nullptr);
+        if (compiled == nullptr) {
+            return nullptr;
+        }
+        Py_DECREF(compiled);
+        if (!valid_asil(g, asil)) {
+            return nullptr;
+        }
+
+        std::vector<parameter> parameters;
+        PyObject* fast = PySequence_Fast(names, "parameters must be a sequence of (name, index)");
+        if (fast == nullptr) {
+            return nullptr;
+        }
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(fast); i++) {
+            const char* node;
+            Py_ssize_t index;
+            if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(fast, i), "sn", &node, &index)) {
+                Py_DECREF(fast);
+                return nullptr;
+            }
+            node_id n = g.find(node);
+            if (n == g.size() || !valid_coefficient(g, n, index)) {
+                PyErr_Clear();
+                PyErr_Format(PyExc_KeyError, "no parameter %s[%zd]", node, index);
+                Py_DECREF(fast);
+                return nullptr;
+            }
+            parameters.push_back(parameter{node, std::size_t(index)});
+        }
+        Py_DECREF(fast);
+
+        Py_buffer view;
+        if (PyObject_GetBuffer(array, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+            return nullptr;
+        }
+        if (view.ndim != 2 || !double_format(view.format)) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "values must be a 2-D C-contiguous float64 array");
+            return nullptr;
+        }
+        if (std::size_t(view.shape[1]) != parameters.size()) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "values must have one column per parameter");
+            return nullptr;
+        }
+
+        std::size_t rows = std::size_t(view.shape[0]);
+        PyObject* result = guarded([&]() -> PyObject* {
+            std::vector<double> out(4 * rows);
+            const double* in = static_cast<const double*>(view.buf);
+            double* spfm = out.data();
+            without_gil([&]() {
+                sc_hw_graph::evaluate_batch(g, asil, parameters, in, rows,
+                                            spfm, spfm + rows, spfm + 2 * rows, spfm + 3 * rows);
+            });
+
+            PyObject* dict = PyDict_New();
+            if (dict == nullptr) {
+                return nullptr;
+            }
+            const char* keys[] = {"spfm", "lfm", "residual", "latent"};
+            for (std::size_t i = 0; i < 4; i++) {
+                PyObject* column = doubles(out.data() + i * rows, rows);
+                if (column == nullptr || PyDict_SetItemString(dict, keys[i], column) != 0) {
+                    Py_XDECREF(column);
+                    Py_DECREF(dict);
+                    return nullptr;
+                }
+                Py_DECREF(column);
+            }
+            return dict;
+        });
+        PyBuffer_Release(&view);
+        return result;
+    }
+
+    // Parameters and structure
+
+    PyObject* graph_coefficient(PyObject* self, PyObject* args)
+    {
+        unsigned int n;
+        Py_ssize_t k;
+        if (!PyArg_ParseTuple(args, "In", &n, &k)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_coefficient(g, n, k)) {
+                return nullptr;
+            }
+            return PyFloat_FromDouble(g.coefficient(n, std::size_t(k)));
+        });
+    }
+
+    PyObject* graph_set_coefficient(PyObject* self, PyObject* args)
+    {
+        unsigned int n;
+        Py_ssize_t k;
+        double c;
+        if (!PyArg_ParseTuple(args, "Ind", &n, &k, &c)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_coefficient(g, n, k)) {
+                return nullptr;
+            }
+            g.set_coefficient(n, std::size_t(k), c);
+            Py_RETURN_NONE;
+        });
+    }
+
+    // Index of the named node, len(graph) if there is none
+    PyObject* graph_find(PyObject* self, PyObject* args)
+    {
+        const char* name;
+        if (!PyArg_ParseTuple(args, "s", &name)) {
+            return nullptr;
+        }
+        return guarded([&]() {
+            graph& g = of(self);
+            g.compile();
+            return PyLong_FromUnsignedLong(g.find(name));
+        });
+    }
+
+    PyObject* graph_name(PyObject* self, PyObject* args)
+    {
+        unsigned int n;
+        if (!PyArg_ParseTuple(args, "I", &n)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_node(g, n)) {
+                return nullptr;
+            }
+            return PyUnicode_FromString(g.name(n).c_str());
+        });
+    }
+
+    PyObject* graph_input(PyObject* self, PyObject* args)
+    {
+        unsigned int n;
+        Py_ssize_t k;
+        if (!PyArg_ParseTuple(args, "In", &n, &k)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_node(g, n)) {
+                return nullptr;
+            }
+            if (k < 0 || std::size_t(k) >= g.input_count(n)) {
+                PyErr_Format(PyExc_IndexError, "node %u has no input %zd", n, k);
+                return nullptr;
+            }
+            return PyLong_FromUnsignedLong(g.input(n, std::size_t(k)).id);
+        });
+    }
+
+    PyObject* graph_output(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"node", "k", nullptr};
+        unsigned int n;
+        Py_ssize_t k = 0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "I|n", const_cast<char**>(kw), &n, &k)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            graph& g = of(self);
+            g.compile();
+            if (!valid_node(g, n)) {
+                return nullptr;
+            }
+            if (k < 0 || std::size_t(k) >= g.output_count(n)) {
+                PyErr_Format(PyExc_IndexError, "node %u has no output %zd", n, k);
+                return nullptr;
+            }
+            return PyLong_FromUnsignedLong(g.output(n, std::size_t(k)).id);
+        });
+    }
+
+    Py_ssize_t graph_length(PyObject* self)
+    {
+        return Py_ssize_t(of(self).size());
+    }
+
+    PyObject* graph_values(PyObject* self, void*)
+    {
+        return PyLong_FromSize_t(of(self).values());
+    }
+
+    PyObject* graph_memory_bytes(PyObject* self, void*)
+    {
+        return PyLong_FromSize_t(of(self).memory_bytes());
+    }
+
+    PyMethodDef graph_methods[] = {
+        {"basic_event", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_basic_event)),
+         METH_VARARGS | METH_KEYWORDS, "basic_event(name, rate) -> value"},
+        {"coverage", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_coverage)),
+         METH_VARARGS | METH_KEYWORDS, "coverage(name, input, dc, lc) -> (output, latent)"},
+        {"split", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_split)),
+         METH_VARARGS | METH_KEYWORDS, "split(name, input, rates) -> [value]"},
+        {"sum", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_sum)),
+         METH_VARARGS | METH_KEYWORDS, "sum(name, inputs) -> value"},
+        {"pass_", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_pass)),
+         METH_VARARGS | METH_KEYWORDS, "pass_(name, input) -> value"},
+        {"asil", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_asil)),
+         METH_VARARGS | METH_KEYWORDS, "asil(name, residual, latent, total) -> node"},
+        {"compile", graph_compile, METH_NOARGS, "Fixes the structure of the graph"},
+        {"evaluate", graph_evaluate, METH_NOARGS, "Evaluates all nodes"},
+        {"read", graph_read, METH_VARARGS, "read(value) -> float"},
+        {"spfm", graph_spfm, METH_VARARGS, "spfm(asil) -> float"},
+        {"lfm", graph_lfm, METH_VARARGS, "lfm(asil) -> float"},
+        {"asil_level", graph_asil_level, METH_VARARGS, "asil_level(asil) -> str"},
+        {"asil_class", graph_asil_class, METH_VARARGS, "asil_class(asil) -> int"},
+        {"outputs", graph_outputs, METH_NOARGS, "Copy of all node outputs, indexed by value"},
+        {"evaluate_batch", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_evaluate_batch)),
+         METH_VARARGS | METH_KEYWORDS, "evaluate_batch(asil, parameters, values) -> dict"},
+        {"coefficient", graph_coefficient, METH_VARARGS, "coefficient(node, k) -> float"},
+        {"set_coefficient", graph_set_coefficient, METH_VARARGS, "set_coefficient(node, k, c)"},
+        {"find", graph_find, METH_VARARGS, "find(name) -> node, len(graph) if there is none"},
+        {"name", graph_name, METH_VARARGS, "name(node) -> str"},
+        {"input", graph_input, METH_VARARGS, "input(node, k) -> value"},
+        {"output", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(graph_output)),
+         METH_VARARGS | METH_KEYWORDS, "output(node, k=0) -> value"},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    PyGetSetDef graph_getset[] = {
+        {"values", graph_values, nullptr, "Number of node outputs", nullptr},
+        {"memory_bytes", graph_memory_bytes, nullptr, "Size of the arena of the compiled graph", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+
+    PyType_Slot graph_slots[] = {
+        {Py_tp_doc, const_cast<char*>("Metric graph of the ISO 26262 hardware metrics")},
+        {Py_tp_new, reinterpret_cast<void*>(graph_new)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(graph_dealloc)},
+        {Py_tp_methods, graph_methods},
+        {Py_tp_getset, graph_getset},
+        {Py_sq_length, reinterpret_cast<void*>(graph_length)},
+        {0, nullptr}
+    };
+
+    PyType_Spec graph_spec = {"iso26262systemc.graph", sizeof(py_graph), 0, Py_TPFLAGS_DEFAULT, graph_slots};
+
+    // Created when the module is imported
+    PyTypeObject* graph_type = nullptr;
+}
+
+// Module
+
+namespace {
+
+    // DRAM model of the examples, with its ASIL node named "ASIL"
+    PyObject* dram_model(PyObject*, PyObject* args, PyObject* kwargs)
+    {
+        static const char* kw[] = {"dram_fit", "other_components", "channels", nullptr};
+        double dram_fit = 2300.0;
+        double other_components = 1900.0;
+        int channels = 1;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ddi", const_cast<char**>(kw),
+                                         &dram_fit, &other_components, &channels)) {
+            return nullptr;
+        }
+        if (channels < 1) {
+            PyErr_SetString(PyExc_ValueError, "channels must be at least 1");
+            return nullptr;
+        }
+
+        PyObject* object = graph_new(graph_type, nullptr, nullptr);
+        if (object == nullptr) {
+            return nullptr;
+        }
+        PyObject* result = guarded([&]() {
+            graph& g = of(object);
+            build_dram_model(g, dram_fit, other_components, dram_parameters<double>(), channels);
+            g.compile();
+            Py_INCREF(object);
+            return object;
+        });
+        Py_DECREF(object);
+        return result;
+    }
+
+    PyMethodDef module_methods[] = {
+        {"dram_model", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(dram_model)),
+         METH_VARARGS | METH_KEYWORDS, "dram_model(dram_fit=2300.0, other_components=1900.0, channels=1) -> graph"},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    PyModuleDef module = {PyModuleDef_HEAD_INIT, "iso26262systemc",
+                          "Graph backend of the ISO 26262 hardware metrics", -1, module_methods,
+                          nullptr, nullptr, nullptr, nullptr};
+}
+
+PyMODINIT_FUNC PyInit_iso26262systemc()
+{
+    sc_core::sc_report_handler::set_actions(sc_core::SC_ERROR, sc_core::SC_DISPLAY | sc_core::SC_THROW);
+    sc_core::sc_report_handler::set_actions(sc_core::SC_FATAL, sc_core::SC_DISPLAY | sc_core::SC_THROW);
+
+    PyObject* m = PyModule_Create(&module);
+    if (m == nullptr) {
+        return nullptr;
+    }
+
+    graph_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&graph_spec));
+    if (graph_type == nullptr) {
+        Py_DECREF(m);
+        return nullptr;
+    }
+    Py_INCREF(graph_type);
+    if (PyModule_AddObject(m, "graph", reinterpret_cast<PyObject*>(graph_type)) < 0) {
+        Py_DECREF(graph_type);
+        Py_DECREF(m);
+        return nullptr;
+    }
+
+    PyObject* levels = PyTuple_New(Py_ssize_t(std::size(sc_hw_metrics::asil_levels)));
+    if (levels == nullptr) {
+        Py_DECREF(m);
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < std::size(sc_hw_metrics::asil_levels); i++) {
+        PyObject* level = PyUnicode_FromString(sc_hw_metrics::asil_levels[i]);
+        if (level == nullptr) {
+            Py_DECREF(levels);
+            Py_DECREF(m);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(levels, Py_ssize_t(i), level);
+    }
+    if (PyModule_AddObject(m, "asil_levels", levels) < 0) {
+        Py_DECREF(levels);
+        Py_DECREF(m);
+        return nullptr;
+    }
+
+    return m;
+}
@@ -0,0 +1,96 @@
+import unittest
+from array import array
+
+import iso26262systemc as iso
+
+# Smoke test of the Python bindings, run by CTest when the bindings are
+# built (ISO26262SYSTEMC_PYTHON). Only the standard library is used, batch
+# inputs are 2-D memoryviews in place of NumPy arrays.
+
+
+def matrix(rows):
+    data = array('d', [x for row in rows for x in row])
+    return memoryview(data).cast('B').cast('d', [len(rows), len(rows[0])])
+
+
+class graph(unittest.TestCase):
+
+    def model(self):
+        g = iso.graph()
+        e = g.basic_event("e", 1000.0)
+        output, latent = g.coverage("c", e, 0.9, 0.5)
+        a = g.asil("ASIL", output, latent, e)
+        g.compile()
+        return g, a
+
+    def test_evaluate(self):
+        g, a = self.model()
+        g.evaluate()
+        self.assertAlmostEqual(g.spfm(a), 90.0)
+        self.assertAlmostEqual(g.lfm(a), 100.0 * (1 - 500.0 / 900.0))
+        self.assertEqual(g.asil_level(a), iso.asil_levels[g.asil_class(a)])
+        self.assertEqual(g.find("c"), 1)
+        self.assertEqual(g.find("none"), len(g))
+        self.assertEqual(g.name(a), "ASIL")
+
+    def test_evaluate_batch(self):
+        g, a = self.model()
+        r = g.evaluate_batch(a, [("c", 0), ("e", 0)], matrix([[0.99, 1000.0], [0.6, 500.0]]))
+        self.assertEqual(len(r["spfm"]), 2)
+        self.assertAlmostEqual(r["spfm"][0], 99.0)
+        self.assertAlmostEqual(r["spfm"][1], 60.0)
+        self.assertAlmostEqual(r["residual"][1], 200.0)
+
+        # The coefficients are restored, a single evaluation agrees
+        self.assertEqual(g.coefficient(g.find("c"), 0), 0.9)
+        g.set_coefficient(g.find("c"), 0, 0.6)
+        g.set_coefficient(g.find("e"), 0, 500.0)
+        g.evaluate()
+        self.assertEqual(g.spfm(a), r["spfm"][1])
+        self.assertEqual(g.lfm(a), r["lfm"][1])
+
+    def test_outputs_are_a_copy(self):
+        g, a = self.model()
+        g.evaluate()
+        outputs = g.outputs()
+        self.assertEqual(len(outputs), g.values)
+        spfm = outputs[g.output(a)]
+        g.set_coefficient(g.find("c"), 0, 0.5)
+        g.evaluate()
+        del g
+        self.assertAlmostEqual(outputs[0], 1000.0)
+        self.assertAlmostEqual(spfm, 90.0)
+
+    def test_dram_model(self):
+        g = iso.dram_model()
+        a = g.find("ASIL")
+        r = g.evaluate_batch(a, [("DRAM_FIT", 0)], matrix([[2300.0]]))
+        g.evaluate()
+        self.assertEqual(r["spfm"][0], g.spfm(a))
+        self.assertGreater(len(iso.dram_model(channels=2)), len(g))
+
+    def test_errors(self):
+        g = iso.graph()
+        e = g.basic_event("e", 1000.0)
+        with self.assertRaises(IndexError):
+            g.pass_("p", e + 1)
+        with self.assertRaises(ValueError):
+            g.coverage("c", e, 1.5, 0.5)
+        with self.assertRaises(RuntimeError):
+            g.split("s", e, [0.7, 0.7])
+        a = g.asil("ASIL", e, e, e)
+        g.compile()
+        with self.assertRaises(RuntimeError):
+            g.basic_event("late", 1.0)
+        with self.assertRaises(IndexError):
+            g.coefficient(a, 0)
+        with self.assertRaises(KeyError):
+            g.evaluate_batch(a, [("none", 0)], matrix([[1.0]]))
+        with self.assertRaises(ValueError):
+            g.evaluate_batch(a, [("e", 0)], matrix([[1.0, 2.0]]))
+        with self.assertRaises(ValueError):
+            g.spfm(0)
+
+
+if __name__ == '__main__':
+    unittest.main()
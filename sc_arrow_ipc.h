@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_ARROW_IPC_H
+#define SC_ARROW_IPC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <systemc>
+
+// Writer for the Arrow IPC file format (Feather v2), e.g. for the results of
+// parameter sweeps. Columns are float64, int64 or utf8 and are bound to
+// variables like in sc_columnar_trace; sample() appends their current values
+// as one row and every rows_per_batch rows are written as one record batch.
+// polars (pl.read_ipc, pl.scan_ipc) and pyarrow (pa.memory_map with
+// pa.ipc.open_file) map the file without parsing or copying the values. The
+// footer is written by close() or the destructor, a file that was not closed
+// can not be read.
+//
+// Only the metadata that these column types need is implemented: the
+// flatbuffers for Schema, RecordBatch and Footer are built by a small
+// serializer below instead of the flatbuffers library.
+
+namespace sc_arrow_ipc {
+
+    namespace detail {
+
+        struct object;
+        using object_ptr = std::shared_ptr<object>;
+
+        // Inline scalar or offset to a child object
+        struct field
+        {
+            bool present = false;
+            std::vector<std::uint8_t> bytes;
+            object_ptr child;
+        };
+
+        struct object
+        {
+            enum class type { table, table_vector, struct_vector, string } kind;
+            std::vector<field> fields;         // table
+            std::vector<object_ptr> elements;  // table_vector
+            std::vector<std::uint8_t> data;    // struct_vector, string
+            std::size_t count = 0;
+
+            explicit object(type kind) : kind(kind) {}
+        };
+
+        inline object_ptr table() {
+            return std::make_shared<object>(object::type::table);
+        }
+
+        inline field& slot(const object_ptr& t, std::size_t id) {
+            if (t->fields.size() <= id) {
+                t->fields.resize(id + 1);
+            }
+            t->fields[id].present = true;
+            return t->fields[id];
+        }
+
+        template <class T>
+        void scalar(const object_ptr& t, std::size_t id, T value) {
+            field& f = slot(t, id);
+            f.bytes.resize(sizeof(T));
+            std::memcpy(f.bytes.data(), &value, sizeof(T));
+        }
+
+        inline void offset(const object_ptr& t, std::size_t id, object_ptr child) {
+            slot(t, id).child = std::move(child);
+        }
+
+        inline object_ptr string(const std::string& s) {
+            auto o = std::make_shared<object>(object::type::string);
+            o->data.assign(s.begin(), s.end());
+            o->count = s.size();
+            return o;
+        }
+
+        inline object_ptr tables(std::vector<object_ptr> elements) {
+            auto o = std::make_shared<object>(object::type::table_vector);
+            o->count = elements.size();
+            o->elements = std::move(elements);
+            return o;
+        }
+
+        // Vector of structs, all of which consist of 8-byte aligned members
+        template <class S>
+        object_ptr structs(const std::vector<S>& elements) {
+            auto o = std::make_shared<object>(object::type::struct_vector);
+            o->data.resize(elements.size() * sizeof(S));
+            if (!elements.empty()) {
+                std::memcpy(o->data.data(), elements.data(), o->data.size());
+            }
+            o->count = elements.size();
+            return o;
+        }
+
+        // Writes the objects front to back: parents before their children,
+        // so all offsets point forward as flatbuffers requires. The vtable of
+        // a table is written right in front of it.
+        class serializer {
+
+        public:
+
+            std::vector<std::uint8_t> finish(const object& root) {
+                buffer.assign(4, 0);
+                put<std::uint32_t>(0, write(root));
+                pad(8);
+                return std::move(buffer);
+            }
+
+        private:
+
+            std::vector<std::uint8_t> buffer;
+
+            void pad(std::size_t align) {
+                buffer.resize((buffer.size() + align - 1) / align * align, 0);
+            }
+
+            template <class T>
+            void put(std::size_t position, T value) {
+                std::memcpy(&buffer[position], &value, sizeof(T));
+            }
+
+            static std::size_t round_up(std::size_t n, std::size_t align) {
+                return (n + align - 1) / align * align;
+            }
+
+            std::size_t write(const object& o) {
+                switch (o.kind) {
+                    case object::type::table:
+                        return write_table(o);
+                    case object::type::table_vector: {
+                        pad(4);
+                        std::size_t position = buffer.size();
+                        buffer.resize(position + 4 + 4 * o.count, 0);
+                        put<std::uint32_t>(position, o.count);
+                        for (std::size_t i = 0; i < o.count; i++) {
+                            std::size_t element = position + 4 + 4 * i;
+                            put<std::uint32_t>(element, write(*o.elements[i]) - element);
+                        }
+                        return position;
+                    }
+                    case object::type::struct_vector: {
+                        // The elements start 8-byte aligned after the length
+                        buffer.resize(round_up(buffer.size() + 4, 8) - 4, 0);
+                        std::size_t position = buffer.size();
+                        buffer.resize(position + 4, 0);
+                        put<std::uint32_t>(position, o.count);
+                        buffer.insert(buffer.end(), o.data.begin(), o.data.end());
+                        return position;
+                    }
+                    case object::type::string: {
+                        pad(4);
+                        std::size_t position = buffer.size();
+                        buffer.resize(position + 4, 0);
+                        put<std::uint32_t>(position, o.count);
+                        buffer.insert(buffer.end(), o.data.begin(), o.data.end());
+                        buffer.push_back(0);
+                        return position;
+                    }
+                }
+                return 0;
+            }
+
+            std::size_t write_table(const object& o) {
+                std::size_t n = o.fields.size();
+                std::size_t align = 4;
+
+                for (auto& f : o.fields) {
+                    if (f.present && !f.child) {
+                        align = std::max(align, f.bytes.size());
+                    }
+                }
+
+                pad(2);
+                std::size_t vtable = buffer.size();
+                std::size_t start = round_up(vtable + 4 + 2 * n, align);
+                std::size_t end = start + 4;
+                std::vector<std::size_t> positions(n, 0);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    auto& f = o.fields[i];
+                    if (f.present) {
+                        std::size_t size = f.child ? 4 : f.bytes.size();
+                        end = round_up(end, size);
+                        positions[i] = end;
+                        end += size;
+                    }
+                }
+
+                buffer.resize(end, 0);
+                put<std::uint16_t>(vtable, 4 + 2 * n);
+                put<std::uint16_t>(vtable + 2, end - start);
+                put<std::int32_t>(start, start - vtable);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    auto& f = o.fields[i];
+                    put<std::uint16_t>(vtable + 4 + 2 * i, f.present ? positions[i] - start : 0);
+                    if (f.present && !f.child) {
+                        std::memcpy(&buffer[positions[i]], f.bytes.data(), f.bytes.size());
+                    }
+                }
+
+                for (std::size_t i = 0; i < n; i++) {
+                    if (o.fields[i].child) {
+                        put<std::uint32_t>(positions[i], write(*o.fields[i].child) - positions[i]);
+                    }
+                }
+
+                return start;
+            }
+        };
+
+        // Structs of the Arrow schema (Message.fbs, File.fbs)
+        struct field_node { std::int64_t length; std::int64_t null_count; };
+        struct buffer { std::int64_t offset; std::int64_t length; };
+        struct block { std::int64_t offset; std::int32_t metadata_length; std::int32_t padding; std::int64_t body_length; };
+
+        static const std::int16_t metadata_v5 = 4;
+        static const std::uint8_t type_int = 2;
+        static const std::uint8_t type_floating_point = 3;
+        static const std::uint8_t type_utf8 = 5;
+        static const std::uint8_t header_schema = 1;
+        static const std::uint8_t header_record_batch = 3;
+    }
+
+    enum class column_type { float64, int64, utf8 };
+
+    class file_writer {
+
+    public:
+
+        file_writer(const std::string& path, std::size_t rows_per_batch = 65536) : path(path),
+                                                                                  rows_per_batch(rows_per_batch),
+                                                                                  file(path, std::ios::out | std::ios::binary | std::ios::trunc)
+        {
+            if (!file.is_open()) {
+                SC_REPORT_ERROR("ARROW", ("Cannot open " + path).c_str());
+            }
+        }
+
+        ~file_writer() {
+            close();
+        }
+
+        file_writer(const file_writer&) = delete;
+        file_writer& operator=(const file_writer&) = delete;
+
+        void column(const double& value, const std::string& name) {
+            add_column(name, column_type::float64, &value);
+        }
+
+        void column(const std::int64_t& value, const std::string& name) {
+            add_column(name, column_type::int64, &value);
+        }
+
+        void column(const std::string& value, const std::string& name) {
+            add_column(name, column_type::utf8, &value);
+        }
+
+        // Appends the current value of every column as one row
+        void sample() {
+            if (columns.empty() || closed) {
+                return;
+            }
+
+            for (auto& c : columns) {
+                switch (c.type) {
+                    case column_type::float64:
+                        c.doubles.push_back(*static_cast<const double*>(c.source));
+                        break;
+                    case column_type::int64:
+                        c.integers.push_back(*static_cast<const std::int64_t*>(c.source));
+                        break;
+                    case column_type::utf8: {
+                        auto& s = *static_cast<const std::string*>(c.source);
+                        c.characters.append(s);
+                        c.offsets.push_back(c.characters.size());
+                        break;
+                    }
+                }
+            }
+
+            if (++rows >= rows_per_batch) {
+                flush();
+            }
+        }
+
+        // Writes the buffered rows as one record batch
+        void flush() {
+            if (closed) {
+                return;
+            }
+
+            write_schema();
+
+            if (rows == 0) {
+                return;
+            }
+
+            std::vector<detail::field_node> nodes;
+            std::vector<detail::buffer> buffers;
+            std::string body;
+
+            auto add_buffer = [&](const void* data, std::size_t bytes) {
+                buffers.push_back(detail::buffer{static_cast<std::int64_t>(body.size()), static_cast<std::int64_t>(bytes)});
+                if (bytes != 0) {
+                    body.append(static_cast<const char*>(data), bytes);
+                }
+                body.resize((body.size() + 7) & ~std::size_t(7), '\0');
+            };
+
+            for (auto& c : columns) {
+                nodes.push_back(detail::field_node{static_cast<std::int64_t>(rows), 0});
+                add_buffer(nullptr, 0); // no validity bitmap, nothing is null
+
+                switch (c.type) {
+                    case column_type::float64:
+                        add_buffer(c.doubles.data(), c.doubles.size() * sizeof(double));
+                        c.doubles.clear();
+                        break;
+                    case column_type::int64:
+                        add_buffer(c.integers.data(), c.integers.size() * sizeof(std::int64_t));
+                        c.integers.clear();
+                        break;
+                    case column_type::utf8:
+                        add_buffer(c.offsets.data(), c.offsets.size() * sizeof(std::int32_t));
+                        add_buffer(c.characters.data(), c.characters.size());
+                        c.offsets.assign(1, 0);
+                        c.characters.clear();
+                        break;
+                }
+            }
+
+            auto batch = detail::table();
+            detail::scalar<std::int64_t>(batch, 0, rows);
+            detail::offset(batch, 1, detail::structs(nodes));
+            detail::offset(batch, 2, detail::structs(buffers));
+
+            batches.push_back(write_message(detail::header_record_batch, batch, body));
+            rows = 0;
+        }
+
+        // Writes the remaining rows and the footer
+        void close() {
+            if (closed) {
+                return;
+            }
+
+            flush();
+
+            std::uint32_t end_of_stream[] = {0xFFFFFFFF, 0};
+            file.write(reinterpret_cast<const char*>(end_of_stream), sizeof(end_of_stream));
+
+            auto footer = detail::table();
+            detail::scalar<std::int16_t>(footer, 0, detail::metadata_v5);
+            detail::offset(footer, 1, schema());
+            detail::offset(footer, 2, detail::structs(std::vector<detail::block>()));
+            detail::offset(footer, 3, detail::structs(batches));
+
+            auto bytes = detail::serializer().finish(*footer);
+            std::int32_t length = bytes.size();
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            file.write("ARROW1", 6);
+            file.close();
+            closed = true;
+        }
+
+        std::size_t size() const {
+            return columns.size();
+        }
+
+    private:
+
+        struct column_data
+        {
+            column_data(const std::string& name, column_type type, const void* source)
+                : name(name), type(type), source(source) {}
+
+            std::string name;
+            column_type type;
+            const void* source;
+            std::vector<double> doubles;
+            std::vector<std::int64_t> integers;
+            std::vector<std::int32_t> offsets{0};
+            std::string characters;
+        };
+
+        std::string path;
+        std::size_t rows_per_batch;
+        std::ofstream file;
+        std::vector<column_data> columns;
+        std::vector<detail::block> batches;
+        std::size_t rows = 0;
+        bool schema_written = false;
+        bool closed = false;
+
+        void add_column(const std::string& name, column_type type, const void* source) {
+            if (schema_written) {
+                SC_REPORT_ERROR("ARROW", "Columns cannot be added after the first record batch");
+                return;
+            }
+
+            if (rows != 0) {
+                SC_REPORT_ERROR("ARROW", "Columns cannot be added after the first sample");
+                return;
+            }
+
+            columns.emplace_back(name, type, source);
+        }
+
+        detail::object_ptr schema() const {
+            std::vector<detail::object_ptr> fields;
+
+            for (auto& c : columns) {
+                auto type = detail::table();
+                std::uint8_t type_id = detail::type_utf8;
+
+                if (c.type == column_type::float64) {
+                    type_id = detail::type_floating_point;
+                    detail::scalar<std::int16_t>(type, 0, 2); // DOUBLE
+                } else if (c.type == column_type::int64) {
+                    type_id = detail::type_int;
+                    detail::scalar<std::int32_t>(type, 0, 64);
+                    detail::scalar<std::uint8_t>(type, 1, 1); // signed
+                }
+
+                auto f = detail::table();
+                detail::offset(f, 0, detail::string(c.name));
+                detail::scalar<std::uint8_t>(f, 1, 0); // not nullable
+                detail::scalar<std::uint8_t>(f, 2, type_id);
+                detail::offset(f, 3, type);
+                detail::offset(f, 5, detail::tables({}));
+                fields.push_back(f);
+            }
+
+            auto s = detail::table();
+            detail::offset(s, 1, detail::tables(fields));
+            return s;
+        }
+
+        void write_schema() {
+            if (schema_written) {
+                return;
+            }
+
+            file.write("ARROW1\0\0", 8);
+            write_message(detail::header_schema, schema(), "");
+            schema_written = true;
+        }
+
+        // Encapsulated message: continuation marker, metadata length,
+        // flatbuffer Message padded to 8 bytes, body
+        detail::block write_message(std::uint8_t header_type, detail::object_ptr header, const std::string& body) {
+            auto message = detail::table();
+            detail::scalar<std::int16_t>(message, 0, detail::metadata_v5);
+            detail::scalar<std::uint8_t>(message, 1, header_type);
+            detail::offset(message, 2, std::move(header));
+            detail::scalar<std::int64_t>(message, 3, body.size());
+
+            auto bytes = detail::serializer().finish(*message);
+            std::uint32_t prefix[] = {0xFFFFFFFF, static_cast<std::uint32_t>(bytes.size())};
+
+            detail::block b{static_cast<std::int64_t>(file.tellp()),
+                            static_cast<std::int32_t>(sizeof(prefix) + bytes.size()), 0,
+                            static_cast<std::int64_t>(body.size())};
+
+            file.write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            file.write(body.data(), body.size());
+            return b;
+        }
+    };
+}
+
+#endif // SC_ARROW_IPC_H
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_COLUMNAR_TRACE_H
+#define SC_COLUMNAR_TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <systemc>
+
+#include "sc_fta.h"
+
+// Binary columnar trace of double and prob values. The layout is
+// (little-endian, every block 8-byte aligned):
+//
+//   char[8]  "SCCOLTR1"
+//   uint32   number of columns C
+//   uint32   reserved
+//   uint64   size S of the string table in bytes
+//   S bytes  string table: C null-terminated column names
+//   padding  up to the next multiple of 8
+//
+// followed by any number of row groups
+//
+//   char[4]  "ROWS"
+//   uint32   reserved
+//   uint64   number of rows N
+//   C x N    float64 values, column after column
+//
+// A trace file that already exists is appended to, e.g. one row group per
+// sweep point, if its columns match. columnar_trace.py maps the row groups
+// into numpy without copying.
+
+namespace sc_columnar_trace {
+
+    static const char file_magic[8] = {'S', 'C', 'C', 'O', 'L', 'T', 'R', '1'};
+    static const char group_magic[4] = {'R', 'O', 'W', 'S'};
+
+    class trace_file {
+
+    public:
+
+        trace_file(const std::string& path, std::size_t rows_per_group = 4096) : path(path),
+                                                                                  rows_per_group(rows_per_group)
+        {
+        }
+
+        // Errors of the last flush are reported as warnings, a destructor
+        // must not throw
+        ~trace_file() {
+            try {
+                flush();
+            } catch (const sc_core::sc_report& report) {
+                SC_REPORT_WARNING("TRACE", report.what());
+            }
+        }
+
+        void trace(const double& value, const std::string& name) {
+            add_column(name, [&value]() { return value; });
+        }
+
+        void trace(const sc_fta::prob& p, const std::string& name) {
+            add_column(name + ".probability", [&p]() { return p.value; });
+        }
+
+        void trace(const sc_core::sc_signal_in_if<double>& signal, const std::string& name) {
+            add_column(name, [&signal]() { return signal.read(); });
+        }
+
+        void trace(const sc_core::sc_signal_in_if<sc_fta::prob>& signal, const std::string& name) {
+            add_column(name + ".probability", [&signal]() { return signal.read().value; });
+        }
+
+        // Registers every double and prob signal of the object hierarchy
+        // under its hierarchical name
+        void trace_all() {
+            for (auto* object : sc_core::sc_get_top_level_objects()) {
+                trace_hierarchy(object);
+            }
+        }
+
+        // Appends the current value of every column as one row
+        void sample() {
+            if (columns.empty()) {
+                return;
+            }
+
+            for (std::size_t i = 0; i < columns.size(); i++) {
+                columns[i].push_back(sources[i]());
+            }
+
+            if (columns.front().size() >= rows_per_group) {
+                flush();
+            }
+        }
+
+        // Writes the buffered rows as one row group
+        void flush() {
+            if (columns.empty() || columns.front().empty()) {
+                return;
+            }
+
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::ate);
+
+            if (!file.is_open()) {
+                file.open(path, std::ios::out | std::ios::binary);
+            }
+
+            // The rows of a failed flush are dropped, so the error is not
+            // reported again by every later flush
+            if (!file.is_open()) {
+                drop();
+                SC_REPORT_ERROR("TRACE", ("Cannot open " + path).c_str());
+                return;
+            }
+
+            if (file.tellp() == std::streampos(0)) {
+                write_header(file);
+            } else if (!header_matches(file)) {
+                drop();
+                SC_REPORT_ERROR("TRACE", ("Columns of " + path + " differ from this trace").c_str());
+                return;
+            }
+
+            std::uint32_t reserved = 0;
+            std::uint64_t rows = columns.front().size();
+
+            file.seekp(0, std::ios::end);
+            file.write(group_magic, sizeof(group_magic));
+            write_value(file, reserved);
+            write_value(file, rows);
+
+            for (auto& column : columns) {
+                file.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(double));
+                column.clear();
+            }
+        }
+
+        std::size_t size() const {
+            return names.size();
+        }
+
+    private:
+
+        std::string path;
+        std::size_t rows_per_group;
+        std::vector<std::string> names;
+        std::vector<std::function<double()>> sources;
+        std::vector<std::vector<double>> columns;
+
+        void drop() {
+            for (auto& column : columns) {
+                column.clear();
+            }
+        }
+
+        void add_column(const std::string& name, std::function<double()> source) {
+            if (!columns.empty() && !columns.front().empty()) {
+                SC_REPORT_ERROR("TRACE", "Columns cannot be added after the first sample");
+                return;
+            }
+
+            names.push_back(name);
+            sources.push_back(std::move(source));
+            columns.emplace_back();
+        }
+
+        void trace_hierarchy(sc_core::sc_object* object) {
+            if (auto* signal = dynamic_cast<sc_core::sc_signal_in_if<double>*>(object)) {
+                trace(*signal, object->name());
+            } else if (auto* signal = dynamic_cast<sc_core::sc_signal_in_if<sc_fta::prob>*>(object)) {
+                trace(*signal, object->name());
+            }
+
+            for (auto* child : object->get_child_objects()) {
+                trace_hierarchy(child);
+            }
+        }
+
+        std::string string_table() const {
+            std::string table;
+            for (auto& name : names) {
+                table.append(name);
+                table.push_back('\0');
+            }
+            table.resize((table.size() + 7) & ~std::size_t(7), '\0');
+            return table;
+        }
+
+        void write_header(std::fstream& file) const {
+            std::string table = string_table();
+            std::uint32_t count = names.size();
+            std::uint32_t reserved = 0;
+            std::uint64_t table_size = table.size();
+
+            file.write(file_magic, sizeof(file_magic));
+            write_value(file, count);
+            write_value(file, reserved);
+            write_value(file, table_size);
+            file.write(table.data(), table.size());
+        }
+
+        bool header_matches(std::fstream& file) const {
+            std::string table = string_table();
+            std::string expected(sizeof(file_magic) + 16 + table.size(), '\0');
+            std::string actual(expected.size(), '\0');
+            std::uint32_t count = names.size();
+            std::uint64_t table_size = table.size();
+
+            std::memcpy(&expected[0], file_magic, sizeof(file_magic));
+            std::memcpy(&expected[8], &count, sizeof(count));
+            std::memcpy(&expected[16], &table_size, sizeof(table_size));
+            std::memcpy(&expected[24], table.data(), table.size());
+
+            file.seekg(0);
+            file.read(&actual[0], actual.size());
+            return file.good() && (actual == expected);
+        }
+
+        template <class T>
+        static void write_value(std::fstream& file, const T& value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    };
+
+    inline void sc_trace(trace_file* tf, const double& value, const std::string& name) {
+        tf->trace(value, name);
+    }
+
+    inline void sc_trace(trace_file* tf, const sc_fta::prob& p, const std::string& name) {
+        tf->trace(p, name);
+    }
+
+    inline void sc_trace(trace_file* tf, const sc_core::sc_signal_in_if<double>& signal, const std::string& name) {
+        tf->trace(signal, name);
+    }
+
+    inline void sc_trace(trace_file* tf, const sc_core::sc_signal_in_if<sc_fta::prob>& signal, const std::string& name) {
+        tf->trace(signal, name);
+    }
+}
+
+#endif // SC_COLUMNAR_TRACE_H
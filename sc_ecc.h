@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_ECC_H
+#define SC_ECC_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <systemc>
+
+#include "sc_parallel.h"
+
+// Exhaustive error pattern analysis of SEC and SEC-DED codes. A code is
+// given by the columns of its parity-check matrix, one r-bit syndrome per
+// codeword bit. Every error pattern of a weight, or every burst up to a
+// length, is decoded and classified, and the residual error that is left in
+// the observed bits (usually the data bits) is counted by weight. The
+// fractions are the split rates of the DRAM models, e.g. for the on-die
+// (136,128) SEC code
+//
+//   DBE -> DBE, TBE     (SEC miscorrection)   analysis[2].rates({2, 3})
+//   TBE -> SBE, DBE, TBE (data bits only)      trim_rates(136, 128, 3)
+//
+// Syndromes are r-bit words, so one XOR computes all syndrome bits of a
+// pattern at once, and patterns are enumerated incrementally on the pool.
+//
+// search() looks for parity-check matrices with fewer miscorrections:
+// annealing chains on every core swap data columns and score them by the
+// number of minimum-weight codewords.
+
+namespace sc_ecc {
+
+    enum class decoder {
+        sec,     // any syndrome equal to a column is corrected
+        sec_ded  // odd-weight columns, even-weight syndromes are detected
+    };
+
+    class code {
+
+    public:
+
+        std::size_t n;                      // codeword bits
+        std::size_t k;                      // data bits, positions 0..k-1
+        std::vector<std::uint64_t> columns; // syndrome of every bit
+        decoder type;
+
+        code(std::size_t k, const std::vector<std::uint64_t>& columns, decoder type) : n(columns.size()),
+                                                                                     k(k),
+                                                                                     columns(columns),
+                                                                                     type(type)
+        {
+            sc_assert(k <= n);
+
+            std::uint64_t all = 0;
+            for (auto c : columns) {
+                all |= c;
+            }
+            r = std::bit_width(all);
+            sc_assert(r <= 24);
+
+            column_of.assign(std::size_t(1) << r, -1);
+            for (std::size_t i = 0; i < n; i++) {
+                if (columns[i] == 0 || column_of[columns[i]] != -1) {
+                    SC_REPORT_FATAL("ECC", "Columns of the parity-check matrix must be distinct and non-zero");
+                }
+                if (type == decoder::sec_ded && std::popcount(columns[i]) % 2 == 0) {
+                    SC_REPORT_FATAL("ECC", "SEC-DED codes need odd-weight columns");
+                }
+                column_of[columns[i]] = i;
+            }
+        }
+
+        // Hamming SEC code with k data bits: unit columns for the parity
+        // bits, the smallest other columns for the data bits
+        static code hamming(std::size_t k) {
+            std::size_t r = 2;
+            while ((std::size_t(1) << r) - r - 1 < k) {
+                r++;
+            }
+
+            std::vector<std::uint64_t> columns;
+            for (std::uint64_t c = 3; columns.size() < k; c++) {
+                if (std::popcount(c) > 1) {
+                    columns.push_back(c);
+                }
+            }
+            for (std::size_t i = 0; i < r; i++) {
+                columns.push_back(std::uint64_t(1) << i);
+            }
+            return code(k, columns, decoder::sec);
+        }
+
+        // Hsiao SEC-DED code with k data bits: odd-weight columns of the
+        // smallest weights
+        static code hsiao(std::size_t k) {
+            std::size_t r = 3;
+            while (odd_columns(r) < k + r) {
+                r++;
+            }
+
+            std::vector<std::uint64_t> columns;
+            for (int w = 3; columns.size() < k; w += 2) {
+                for (std::uint64_t c = 0; c < (std::uint64_t(1) << r) && columns.size() < k; c++) {
+                    if (std::popcount(c) == w) {
+                        columns.push_back(c);
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < r; i++) {
+                columns.push_back(std::uint64_t(1) << i);
+            }
+            return code(k, columns, decoder::sec_ded);
+        }
+
+        std::size_t parity_bits() const {
+            return r;
+        }
+
+        // Bit corrected for a syndrome, -1 for none, -2 for a detected error
+        int decode(std::uint64_t syndrome) const {
+            if (syndrome == 0) {
+                return -1;
+            }
+            if (type == decoder::sec_ded && std::popcount(syndrome) % 2 == 0) {
+                return -2;
+            }
+            return (syndrome < column_of.size() && column_of[syndrome] >= 0) ? column_of[syndrome] : -2;
+        }
+
+        inline friend std::ostream& operator << (std::ostream& os, const code& c) {
+            os << "(" << c.n << "," << c.k << ") " << (c.type == decoder::sec ? "SEC" : "SEC-DED") << std::hex;
+            for (auto column : c.columns) {
+                os << " " << std::setw((c.r + 3) / 4) << std::setfill('0') << column;
+            }
+            return os << std::dec << std::setfill(' ');
+        }
+
+    private:
+
+        std::size_t r;
+        std::vector<int> column_of;
+
+        static std::size_t odd_columns(std::size_t r) {
+            std::size_t count = 0;
+            for (std::uint64_t c = 0; c < (std::uint64_t(1) << r); c++) {
+                count += std::popcount(c) % 2;
+            }
+            return count;
+        }
+    };
+
+    // Outcome of all patterns of one class, e.g. all DBEs. The fractions add
+    // up to one. observed[w] is the fraction of patterns that leave an error
+    // of weight w in the observed bits after decoding, whether or not the
+    // decoder flagged it.
+    struct analysis
+    {
+        std::uint64_t patterns = 0;
+        double corrected = 0.0;         // no error left in the codeword
+        double detected = 0.0;          // uncorrectable, flagged by the decoder
+        double undetected = 0.0;        // zero syndrome, the error stays
+        double miscorrected = 0.0;      // a wrong bit was flipped
+        std::vector<double> codeword;   // error weight in the codeword after decoding
+        std::vector<double> observed;   // error weight in the observed bits after decoding
+
+        // Fractions of the given codeword error weights after decoding, e.g.
+        // {2, 3} for the split of DBEs into DBEs and miscorrected TBEs
+        std::vector<double> rates(const std::vector<std::size_t>& weights) const {
+            std::vector<double> r;
+            for (auto w : weights) {
+                r.push_back(w < codeword.size() ? codeword[w] : 0.0);
+            }
+            return r;
+        }
+
+        // Fractions of observed error weights 1..max_weight, the order of
+        // the SBE, DBE and TBE outputs of the trim splits
+        std::vector<double> observed_rates(std::size_t max_weight) const {
+            std::vector<double> r;
+            for (std::size_t w = 1; w <= max_weight; w++) {
+                r.push_back(w < observed.size() ? observed[w] : 0.0);
+            }
+            return r;
+        }
+
+        inline friend std::ostream& operator << (std::ostream& os, const analysis& a) {
+            os << a.patterns << " patterns: corrected " << a.corrected << ", detected " << a.detected
+               << ", undetected " << a.undetected << ", miscorrected " << a.miscorrected << ", observed";
+            for (std::size_t w = 0; w < a.observed.size(); w++) {
+                os << " " << w << ":" << a.observed[w];
+            }
+            return os;
+        }
+    };
+
+    namespace detail {
+
+        struct counts
+        {
+            std::uint64_t patterns = 0, corrected = 0, detected = 0, undetected = 0, miscorrected = 0;
+            std::vector<std::uint64_t> codeword, observed;
+
+            explicit counts(std::size_t max_weight) : codeword(max_weight + 2, 0), observed(max_weight + 2, 0) {}
+
+            void add(const counts& c) {
+                patterns += c.patterns;
+                corrected += c.corrected;
+                detected += c.detected;
+                undetected += c.undetected;
+                miscorrected += c.miscorrected;
+                for (std::size_t i = 0; i < codeword.size(); i++) {
+                    codeword[i] += c.codeword[i];
+                    observed[i] += c.observed[i];
+                }
+            }
+
+            analysis result() const {
+                analysis a;
+                double total = std::max<std::uint64_t>(patterns, 1);
+                a.patterns = patterns;
+                a.corrected = corrected / total;
+                a.detected = detected / total;
+                a.undetected = undetected / total;
+                a.miscorrected = miscorrected / total;
+                for (std::size_t i = 0; i < codeword.size(); i++) {
+                    a.codeword.push_back(codeword[i] / total);
+                    a.observed.push_back(observed[i] / total);
+                }
+                return a;
+            }
+        };
+
+        // Classifies one pattern of the given bits and syndrome
+        inline void classify(const code& c, const std::vector<char>& mask, const std::size_t* bits,
+                             std::size_t weight, std::uint64_t syndrome, counts& n)
+        {
+            int fix = c.decode(syndrome);
+            std::size_t in_pattern = 0, observed = 0;
+
+            for (std::size_t i = 0; i < weight; i++) {
+                observed += mask[bits[i]];
+                in_pattern += (int(bits[i]) == fix);
+            }
+
+            std::size_t left = weight;
+
+            if (fix == -1) {
+                n.undetected += (weight != 0);
+            } else if (fix == -2) {
+                n.detected++;
+            } else if (in_pattern && weight == 1) {
+                n.corrected++;
+                left = 0;
+                observed = 0;
+            } else {
+                n.miscorrected++;
+                left = in_pattern ? weight - 1 : weight + 1;
+                observed = in_pattern ? observed - mask[fix] : observed + mask[fix];
+            }
+
+            n.patterns++;
+            n.codeword[left]++;
+            n.observed[observed]++;
+        }
+    }
+
+    // Observed bits: the data bits of the code
+    inline std::vector<char> data_bits(const code& c)
+    {
+        std::vector<char> mask(c.n, 0);
+        std::fill(mask.begin(), mask.begin() + c.k, 1);
+        return mask;
+    }
+
+    // All patterns of the given weight. The first bit of the pattern is
+    // distributed over the pool.
+    inline analysis analyze(const code& c, std::size_t weight, sc_parallel::thread_pool& pool,
+                            const std::vector<char>& mask)
+    {
+        sc_assert(weight >= 1 && weight <= c.n && mask.size() == c.n);
+
+        std::vector<detail::counts> partial(c.n, detail::counts(weight));
+
+        pool.parallel_for(c.n - weight + 1, [&](std::size_t first) {
+            std::vector<std::size_t> bits(weight);
+            detail::counts& n = partial[first];
+
+            std::function<void(std::size_t, std::size_t, std::uint64_t)> enumerate =
+                [&](std::size_t depth, std::size_t next, std::uint64_t syndrome) {
+                    if (depth == weight) {
+                        detail::classify(c, mask, bits.data(), weight, syndrome, n);
+                        return;
+                    }
+                    for (std::size_t b = next; b + (weight - depth) <= c.n; b++) {
+                        bits[depth] = b;
+                        enumerate(depth + 1, b + 1, syndrome ^ c.columns[b]);
+                    }
+                };
+
+            bits[0] = first;
+            enumerate(1, first + 1, c.columns[first]);
+        });
+
+        detail::counts total(weight);
+        for (auto& p : partial) {
+            total.add(p);
+        }
+        return total.result();
+    }
+
+    inline analysis analyze(const code& c, std::size_t weight, sc_parallel::thread_pool& pool)
+    {
+        return analyze(c, weight, pool, data_bits(c));
+    }
+
+    // All bursts of exactly the given length in codeword bit order: first
+    // and last bit flipped, any bits in between
+    inline analysis analyze_bursts(const code& c, std::size_t length, sc_parallel::thread_pool& pool,
+                                   const std::vector<char>& mask)
+    {
+        sc_assert(length >= 2 && length <= c.n && length <= 32 && mask.size() == c.n);
+
+        std::vector<detail::counts> partial(c.n - length + 1, detail::counts(length));
+
+        pool.parallel_for(partial.size(), [&](std::size_t first) {
+            std::vector<std::size_t> bits(length);
+            std::uint64_t inner = std::uint64_t(1) << (length - 2);
+
+            for (std::uint64_t m = 0; m < inner; m++) {
+                std::size_t weight = 0;
+                std::uint64_t syndrome = 0;
+
+                for (std::size_t i = 0; i < length; i++) {
+                    if (i == 0 || i == length - 1 || ((m >> (i - 1)) & 1)) {
+                        bits[weight++] = first + i;
+                        syndrome ^= c.columns[first + i];
+                    }
+                }
+                detail::classify(c, mask, bits.data(), weight, syndrome, partial[first]);
+            }
+        });
+
+        detail::counts total(length);
+        for (auto& p : partial) {
+            total.add(p);
+        }
+        return total.result();
+    }
+
+    inline analysis analyze_bursts(const code& c, std::size_t length, sc_parallel::thread_pool& pool)
+    {
+        return analyze_bursts(c, length, pool, data_bits(c));
+    }
+
+    // Split of errors of the given weight in n bits by the number of bits
+    // that fall into kept of them (hypergeometric), for weights 1..weight
+    inline std::vector<double> trim_rates(std::size_t n, std::size_t kept, std::size_t weight)
+    {
+        sc_assert(kept <= n && weight <= n);
+
+        auto choose = [](std::size_t a, std::size_t b) {
+            if (b > a) {
+                return 0.0;
+            }
+            double r = 1.0;
+            for (std::size_t i = 1; i <= b; i++) {
+                r = r * (a - b + i) / i;
+            }
+            return r;
+        };
+
+        std::vector<double> rates;
+        for (std::size_t w = 1; w <= weight; w++) {
+            rates.push_back(choose(kept, w) * choose(n - kept, weight - w) / choose(n, weight));
+        }
+        return rates;
+    }
+
+    // Number of minimum-weight codewords, updated in O(n) when a column
+    // changes. With distinct non-zero columns these are the weight-3
+    // codewords of SEC codes, each turns 3 DBEs into TBEs, and the weight-4
+    // codewords of SEC-DED codes, each turns 4 TBEs into miscorrected MBEs.
+    // pairs[s] counts the column pairs with syndrome s: a SEC pair collides
+    // if s is a column, two SEC-DED pairs collide if their syndromes match.
+    class codeword_counter {
+
+    public:
+
+        std::vector<std::uint64_t> columns;
+
+        explicit codeword_counter(const code& c) : columns(c.columns),
+                                                   sec_ded(c.type == decoder::sec_ded),
+                                                   pairs(std::size_t(1) << c.parity_bits(), 0),
+                                                   member(std::size_t(1) << c.parity_bits(), 0)
+        {
+            for (std::size_t i = 0; i < columns.size(); i++) {
+                add(i);
+            }
+        }
+
+        std::uint64_t codewords() const {
+            return total / 3;
+        }
+
+        bool used(std::uint64_t syndrome) const {
+            return member[syndrome];
+        }
+
+        void replace(std::size_t i, std::uint64_t syndrome) {
+            remove(i);
+            columns[i] = syndrome;
+            add(i);
+        }
+
+    private:
+
+        bool sec_ded;
+        std::vector<std::uint32_t> pairs;
+        std::vector<char> member;
+        std::uint64_t total = 0;    // 3 times the codewords
+
+        void remove(std::size_t i) {
+            std::uint64_t c = columns[i];
+            member[c] = 0;
+            if (!sec_ded) {
+                total -= pairs[c];
+            }
+            for (std::size_t j = 0; j < columns.size(); j++) {
+                if (j != i && member[columns[j]]) {
+                    std::uint64_t s = c ^ columns[j];
+                    pairs[s]--;
+                    total -= sec_ded ? pairs[s] : member[s];
+                }
+            }
+        }
+
+        void add(std::size_t i) {
+            std::uint64_t c = columns[i];
+            for (std::size_t j = 0; j < columns.size(); j++) {
+                if (j != i && member[columns[j]]) {
+                    std::uint64_t s = c ^ columns[j];
+                    total += sec_ded ? pairs[s] : member[s];
+                    pairs[s]++;
+                }
+            }
+            if (!sec_ded) {
+                total += pairs[c];
+            }
+            member[c] = 1;
+        }
+    };
+
+    struct search_options
+    {
+        std::size_t chains = 0;             // 0: one per thread of the pool
+        std::size_t iterations = 20000;     // column swaps per chain
+        double initial_temperature = 20.0;
+        double final_temperature = 0.05;
+        std::uint64_t seed = 1;
+    };
+
+    // Best code of one chain with the split of the pattern weight it
+    // miscorrects: DBEs for SEC, TBEs for SEC-DED
+    struct candidate
+    {
+        code c;
+        std::uint64_t codewords;
+        analysis miscorrection;
+    };
+
+    // Simulated annealing over the data columns of start, the parity
+    // columns stay fixed. Every chain swaps a data column for an unused
+    // column of the same kind (weight >= 2 for SEC, odd weight >= 3 for
+    // SEC-DED) and accepts worse codes with exp(-delta / temperature). The
+    // chains run independently on the pool; the best codes come first.
+    inline std::vector<candidate> search(const code& start, const search_options& options,
+                                         sc_parallel::thread_pool& pool)
+    {
+        std::size_t chains = options.chains ? options.chains : pool.size();
+        std::size_t weight = (start.type == decoder::sec) ? 2 : 3;
+
+        std::vector<std::uint64_t> pool_columns;
+        for (std::uint64_t s = 1; s < (std::uint64_t(1) << start.parity_bits()); s++) {
+            int w = std::popcount(s);
+            if (start.type == decoder::sec ? (w >= 2) : (w >= 3 && w % 2 == 1)) {
+                pool_columns.push_back(s);
+            }
+        }
+
+        if (pool_columns.size() <= start.k) {
+            SC_REPORT_WARNING("ECC", "No unused columns to search with");
+        }
+
+        std::vector<std::vector<std::uint64_t>> best(chains);
+        std::vector<std::uint64_t> best_codewords(chains);
+
+        pool.parallel_for(chains, [&](std::size_t chain) {
+            std::mt19937_64 random(options.seed + chain);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            codeword_counter counter(start);
+
+            best[chain] = counter.columns;
+            best_codewords[chain] = counter.codewords();
+
+            if (pool_columns.size() <= start.k || start.k == 0) {
+                return;
+            }
+
+            double cooling = std::pow(options.final_temperature / options.initial_temperature,
+                                      1.0 / std::max<std::size_t>(options.iterations, 1));
+            double temperature = options.initial_temperature;
+
+            for (std::size_t i = 0; i < options.iterations; i++, temperature *= cooling) {
+                std::size_t column = random() % start.k;
+                std::uint64_t syndrome;
+                do {
+                    syndrome = pool_columns[random() % pool_columns.size()];
+                } while (counter.used(syndrome));
+
+                std::uint64_t before = counter.codewords();
+                std::uint64_t old = counter.columns[column];
+                counter.replace(column, syndrome);
+                double delta = double(counter.codewords()) - double(before);
+
+                if (delta > 0 && uniform(random) >= std::exp(-delta / temperature)) {
+                    counter.replace(column, old);
+                } else if (counter.codewords() < best_codewords[chain]) {
+                    best[chain] = counter.columns;
+                    best_codewords[chain] = counter.codewords();
+                }
+            }
+        });
+
+        std::vector<candidate> result;
+        for (std::size_t chain = 0; chain < chains; chain++) {
+            code c(start.k, best[chain], start.type);
+            analysis a = analyze(c, weight, pool);
+            result.push_back(candidate{std::move(c), best_codewords[chain], std::move(a)});
+        }
+
+        std::stable_sort(result.begin(), result.end(), [](const candidate& a, const candidate& b) {
+            return a.codewords < b.codewords;
+        });
+        return result;
+    }
+}
+
+#endif // SC_ECC_H
@@ -33,7 +33,14 @@
  *    Matthias Jung
  */
 
+#ifndef SC_FTA_H
+#define SC_FTA_H
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <systemc>
 
 namespace sc_fta {
@@ -91,4 +98,168 @@ namespace sc_fta {
             return os << p.value << " (" << (p.value * 1e9) << " FIT)";
         }
     };
-}
\ No newline at end of file
+    // Common cause failures of a group of m identical components with the
+    // total failure probability Qt each. fractions[k - 1] is Q_k / Qt, where
+    // Q_k is the probability of the basic event that fails one specific set
+    // of k components together. Every component fails by the events that
+    // contain it, so sum_k C(m - 1, k - 1) Q_k = Qt.
+    struct ccf_model
+    {
+        std::vector<double> fractions;
+
+        std::size_t size() const {
+            return fractions.size();
+        }
+    };
+
+    inline double binomial(std::size_t n, std::size_t k)
+    {
+        double b = 1.0;
+        for (std::size_t i = 1; i <= k; i++) {
+            b = b * (n - k + i) / i;
+        }
+        return b;
+    }
+
+    // The fraction beta of the failures of a component fails all m
+    inline ccf_model beta_factor(std::size_t m, double beta)
+    {
+        sc_assert(m >= 1 && beta >= 0.0 && beta <= 1.0);
+        ccf_model model{std::vector<double>(m, 0.0)};
+        model.fractions[0] = (m == 1) ? 1.0 : 1.0 - beta;
+        if (m > 1) {
+            model.fractions[m - 1] = beta;
+        }
+        return model;
+    }
+
+    // Multiple Greek letters: factors[0] = beta, factors[1] = gamma, ... is
+    // the probability that a failure that is shared with at least k - 1
+    // other components is shared with at least k. Missing factors are 0.
+    inline ccf_model multiple_greek_letters(std::size_t m, const std::vector<double>& factors)
+    {
+        sc_assert(m >= 1);
+        ccf_model model{std::vector<double>(m, 0.0)};
+        double shared = 1.0; // rho_1 * ... * rho_k
+
+        for (std::size_t k = 1; k <= m; k++) {
+            double next = (k < m && k - 1 < factors.size()) ? factors[k - 1] : 0.0;
+            sc_assert(next >= 0.0 && next <= 1.0);
+            model.fractions[k - 1] = shared * (1.0 - next) / binomial(m - 1, k - 1);
+            shared *= next;
+        }
+        return model;
+    }
+
+    // Alpha factors: alphas[k - 1] is the fraction of the failure events of
+    // the group that fail exactly k components, for non-staggered or
+    // staggered testing
+    inline ccf_model alpha_factor(const std::vector<double>& alphas, bool staggered = false)
+    {
+        std::size_t m = alphas.size();
+        sc_assert(m >= 1);
+        ccf_model model{std::vector<double>(m, 0.0)};
+        double alpha_t = 0.0;
+        double alpha_sum = 0.0;
+
+        for (std::size_t k = 1; k <= m; k++) {
+            sc_assert(alphas[k - 1] >= 0.0);
+            alpha_t += k * alphas[k - 1];
+            alpha_sum += alphas[k - 1];
+        }
+
+        // Every failure event of the group fails some number of components
+        sc_assert(std::abs(alpha_sum - 1.0) < 1e-9);
+
+        for (std::size_t k = 1; k <= m; k++) {
+            model.fractions[k - 1] = staggered ? alphas[k - 1] / binomial(m - 1, k - 1)
+                                               : k * alphas[k - 1] / (binomial(m - 1, k - 1) * alpha_t);
+        }
+        return model;
+    }
+
+    // Probability that at least k of the m components of a CCF group fail,
+    // e.g. k = m for redundant units or k = 2 for a 2-out-of-3 voter. The
+    // rare event approximation sums over the minimal cut sets of disjoint
+    // CCF events; overlapping events are of higher order in the CCF factors
+    // and are neglected. The cut sets are never built: they are counted per
+    // number of events r once in the constructor, so every evaluation is a
+    // polynomial in Qt of degree at most k.
+    SC_MODULE(ccf_group)
+    {
+        sc_core::sc_in<prob> input;   // Qt of one component
+        sc_core::sc_out<prob> output;
+
+        std::vector<double> coefficients; // of Qt^r
+
+        ccf_group(const sc_core::sc_module_name& name, const ccf_model& model, std::size_t k) : input("input"),
+                                                                                               output("output")
+        {
+            std::size_t m = model.size();
+
+            if (k < 1 || k > m) {
+                SC_REPORT_FATAL("CCF", (std::string(this->name()) + ": k must be between 1 and the group size").c_str());
+            }
+
+            // table[s][r]: collections of r disjoint events of the sizes done
+            // so far that fail s components, each weighted with
+            // prod fraction_b / b! / multiplicity!
+            std::vector<std::vector<double>> table(m + 1, std::vector<double>(k + 1, 0.0));
+            table[0][0] = 1.0;
+            coefficients.assign(k + 1, 0.0);
+
+            // Largest size first, so the collections of the current size j
+            // are the ones whose smallest event has size j: they are minimal
+            // if they fail at least k components but less than k + j
+            for (std::size_t j = m; j >= 1; j--) {
+                double weight = model.fractions[j - 1];
+                for (std::size_t i = 2; i <= j; i++) {
+                    weight /= i;
+                }
+
+                std::vector<std::vector<double>> next = table;
+                double power = 1.0;
+
+                for (std::size_t c = 1; c * j <= m && c <= k && weight > 0.0; c++) {
+                    power = power * weight / c;
+                    for (std::size_t s = c * j; s <= m; s++) {
+                        for (std::size_t r = c; r <= k; r++) {
+                            double t = power * table[s - c * j][r - c];
+                            next[s][r] += t;
+                            if (s >= k && s < k + j) {
+                                coefficients[r] += t * falling(m, s);
+                            }
+                        }
+                    }
+                }
+                table.swap(next);
+            }
+
+            SC_METHOD(compute_prob);
+            sensitive << input;
+        }
+
+        void compute_prob() {
+            double qt = input.read().value;
+            double p = 0.0;
+
+            for (std::size_t r = coefficients.size(); r-- > 0;) {
+                p = p * qt + coefficients[r];
+            }
+            output.write(prob(std::min(p, 1.0)));
+        }
+
+    private:
+
+        // m! / (m - s)!
+        static double falling(std::size_t m, std::size_t s) {
+            double f = 1.0;
+            for (std::size_t i = 0; i < s; i++) {
+                f *= m - i;
+            }
+            return f;
+        }
+    };
+}
+
+#endif // SC_FTA_H
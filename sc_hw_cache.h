@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_CACHE_H
+#define SC_HW_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+
+// Persistent result cache for the graph backend. Every node gets a Merkle
+// hash over its kind, its coefficients and the hashes of the nodes driving
+// its inputs, so the hash identifies the whole subtree below the node
+// independent of node names and of the rest of the graph. Node outputs are
+// stored on disk under that hash, and cached evaluation skips every subtree
+// whose result is already known.
+//
+// A node hash mixes a sum of one term per coefficient and input, each
+// term a mix of the word and its position. A cached_graph keeps these sums
+// between evaluations and, when a coefficient or the hash of an input
+// changes, only replaces that term. Following a changed parameter costs one
+// update per edge downstream of it, independent of the number of inputs of
+// the sums on the way: a repeated sweep point costs one lookup, a changed
+// parameter only re-evaluates the nodes downstream of it.
+//
+// The hashes include semantics_version, which has to be incremented with
+// every change of how a node computes its outputs or of the hash function,
+// so that results of an older version are not reused. The store keeps at
+// most a given number of records and starts over when it is full.
+//
+// The file is a header followed by appended records (little-endian):
+//
+//   char[8]  "SCHWC001"
+//   records  uint64 hash, uint32 count, uint32 reserved, count x float64
+
+namespace sc_hw_cache {
+
+    static const char file_magic[8] = {'S', 'C', 'H', 'W', 'C', '0', '0', '1'};
+
+    // Version of the node semantics of sc_hw_graph and of the node hashes
+    static const std::uint32_t semantics_version = 2;
+
+    using hash = std::uint64_t;
+
+    // splitmix64 finalizer
+    inline hash mix(hash z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    class hasher {
+
+    public:
+
+        // Mixes in one value of up to 64 bits as a whole word
+        template <class T>
+        hasher& add(const T& value) {
+            static_assert(sizeof(T) <= sizeof(std::uint64_t), "hasher::add takes at most 64 bits");
+            std::uint64_t word = 0;
+            std::memcpy(&word, &value, sizeof(T));
+            h = (h ^ word) * 0x100000001b3ull;
+            h ^= h >> 32;
+            return *this;
+        }
+
+        // FNV-1a over words followed by the splitmix64 finalizer
+        hash get() const {
+            return mix(h);
+        }
+
+    private:
+
+        hash h = 0xcbf29ce484222325ull;
+    };
+
+    // Term of one coefficient or input hash at the given position of a node
+    inline hash term(hash word, std::uint64_t position)
+    {
+        return mix(word ^ (position * 0x9e3779b97f4a7c15ull));
+    }
+
+    // Inputs are numbered after the coefficients
+    static const std::uint64_t input_position = std::uint64_t(1) << 32;
+
+    inline hash coefficient_term(double c, std::size_t k)
+    {
+        c = c + 0.0; // -0.0 and 0.0 are the same parameter
+        hash word;
+        std::memcpy(&word, &c, sizeof(word));
+        return term(word, k);
+    }
+
+    // Hash of everything but the terms: version, kind and counts
+    inline hash node_header(const sc_hw_graph::graph& g, sc_hw_graph::node_id n)
+    {
+        return hasher().add(semantics_version).add(g.node_kind(n)).add(std::uint32_t(g.coefficient_count(n)))
+                       .add(std::uint32_t(g.input_count(n))).get();
+    }
+
+    inline hash node_hash(hash header, hash terms)
+    {
+        return mix(header + terms);
+    }
+
+    // Subtree hash of node n, from the hashes of the values at its inputs
+    inline hash node_hash(const sc_hw_graph::graph& g, sc_hw_graph::node_id n, const std::vector<hash>& value_hashes)
+    {
+        hash terms = 0;
+        for (std::size_t k = 0; k < g.coefficient_count(n); k++) {
+            terms += coefficient_term(g.coefficient(n, k), k);
+        }
+        for (std::size_t i = 0; i < g.input_count(n); i++) {
+            terms += term(value_hashes[g.input(n, i).id], input_position + i);
+        }
+        return node_hash(node_header(g, n), terms);
+    }
+
+    inline hash output_hash(hash node, std::size_t k)
+    {
+        return term(node, k + 1);
+    }
+
+    // Subtree hash of every node of g, indexed by node id
+    inline std::vector<hash> node_hashes(sc_hw_graph::graph& g)
+    {
+        g.compile();
+
+        std::vector<hash> hashes(g.size());
+        std::vector<hash> value_hashes(g.values());
+
+        for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+            hashes[n] = node_hash(g, n, value_hashes);
+            for (std::size_t k = 0; k < g.output_count(n); k++) {
+                value_hashes[g.output(n, k).id] = output_hash(hashes[n], k);
+            }
+        }
+
+        return hashes;
+    }
+
+    // Hash of the whole graph: its structure and all parameters
+    inline hash graph_hash(sc_hw_graph::graph& g)
+    {
+        hasher h;
+        for (auto n : node_hashes(g)) {
+            h.add(n);
+        }
+        return h.get();
+    }
+
+    // On-disk key-value store of result vectors. All records are loaded on
+    // construction, new ones are appended. When capacity records are
+    // reached, the store is cleared and the file rewritten. Not safe for
+    // concurrent writers.
+    class store {
+
+    public:
+
+        explicit store(const std::string& path, std::size_t capacity = std::size_t(1) << 20) : path(path),
+                                                                                              capacity(capacity)
+        {
+            std::ifstream in(path, std::ios::binary);
+
+            if (!in.is_open()) {
+                return;
+            }
+
+            char magic[sizeof(file_magic)];
+            if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, file_magic, sizeof(magic)) != 0) {
+                SC_REPORT_ERROR("CACHE", (path + " is not a result cache").c_str());
+                return;
+            }
+
+            valid_bytes = sizeof(file_magic);
+
+            hash key;
+            std::uint32_t count, reserved;
+            while (in.read(reinterpret_cast<char*>(&key), sizeof(key))
+                   && in.read(reinterpret_cast<char*>(&count), sizeof(count))
+                   && in.read(reinterpret_cast<char*>(&reserved), sizeof(reserved))) {
+                std::vector<double> values(count);
+                if (!in.read(reinterpret_cast<char*>(values.data()), count * sizeof(double))) {
+                    break;
+                }
+                records[key] = std::move(values);
+                valid_bytes += sizeof(key) + 2 * sizeof(std::uint32_t) + count * sizeof(double);
+            }
+        }
+
+        ~store() {
+            close();
+        }
+
+        const std::vector<double>* find(hash key) const {
+            auto it = records.find(key);
+            return (it == records.end()) ? nullptr : &it->second;
+        }
+
+        void put(hash key, const std::vector<double>& values) {
+            auto [it, inserted] = records.emplace(key, values);
+            if (!inserted) {
+                if (it->second == values) {
+                    return;
+                }
+                it->second = values;
+            }
+
+            if (inserted && records.size() > capacity) {
+                clear();
+                records.emplace(key, values);
+            }
+
+            if (!file.is_open()) {
+                open();
+            }
+
+            std::uint32_t count = values.size();
+            std::uint32_t reserved = 0;
+            file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+            file.write(reinterpret_cast<const char*>(values.data()), count * sizeof(double));
+        }
+
+        void close() {
+            if (file.is_open()) {
+                file.close();
+            }
+        }
+
+        std::size_t size() const {
+            return records.size();
+        }
+
+        // Drops all records, the file is rewritten by the next put
+        void clear() {
+            close();
+            records.clear();
+            valid_bytes = 0;
+        }
+
+    private:
+
+        std::string path;
+        std::size_t capacity;
+        std::unordered_map<hash, std::vector<double>> records;
+        std::ofstream file;
+        std::size_t valid_bytes = 0;
+
+        // A record cut off by an interrupted run is dropped before appending
+        void open() {
+            if (valid_bytes == 0) {
+                file.open(path, std::ios::binary | std::ios::trunc);
+                file.write(file_magic, sizeof(file_magic));
+            } else {
+                std::filesystem::resize_file(path, valid_bytes);
+                file.open(path, std::ios::binary | std::ios::app);
+            }
+
+            if (!file.is_open()) {
+                SC_REPORT_ERROR("CACHE", ("Cannot open " + path).c_str());
+            }
+        }
+    };
+
+    struct statistics
+    {
+        std::size_t evaluated = 0; // nodes computed
+        std::size_t loaded = 0;    // nodes read from the cache
+        std::size_t skipped = 0;   // nodes below a cached node
+        std::size_t hashed = 0;    // nodes hashed again
+        std::size_t current = 0;   // nodes whose outputs were still valid
+    };
+
+    // Cached evaluation of one compiled graph. The node hashes and their
+    // term sums are kept between evaluations. While a cached_graph is used,
+    // coefficients must be changed through its set_coefficient, which
+    // replaces the term of the coefficient and marks the node; the next
+    // evaluation hashes the marked nodes and, where a hash changed, replaces
+    // its terms in the nodes it drives and marks them. A node whose hash is
+    // the same as when its outputs were last computed or loaded is neither
+    // looked up nor visited further, so the outputs of g must not be
+    // written by others in between.
+    class cached_graph {
+
+    public:
+
+        cached_graph(sc_hw_graph::graph& g, store& cache) : g(g), cache(cache)
+        {
+            g.compile();
+
+            std::size_t size = g.size();
+            headers.resize(size);
+            terms.assign(size, 0);
+            node_hashes.assign(size, 0);
+            value_hashes.assign(g.values(), 0);
+            valid_hashes.assign(size, 0);
+            valid.assign(size, 0);
+            owner.resize(g.values());
+            dirty.assign(size, 1);
+            needed.assign(size, 0);
+            first_dirty = 0;
+
+            // Terms for inputs whose hash is still 0, replaced by the first
+            // rehash
+            edge_offsets.assign(g.values() + 1, 0);
+            for (sc_hw_graph::node_id n = 0; n < size; n++) {
+                headers[n] = node_header(g, n);
+                for (std::size_t k = 0; k < g.coefficient_count(n); k++) {
+                    terms[n] += coefficient_term(g.coefficient(n, k), k);
+                }
+                for (std::size_t i = 0; i < g.input_count(n); i++) {
+                    terms[n] += term(0, input_position + i);
+                    edge_offsets[g.input(n, i).id + 1]++;
+                }
+                for (std::size_t k = 0; k < g.output_count(n); k++) {
+                    owner[g.output(n, k).id] = n;
+                }
+            }
+
+            // Inputs fed by each value
+            for (std::size_t v = 0; v < g.values(); v++) {
+                edge_offsets[v + 1] += edge_offsets[v];
+            }
+            edges.resize(edge_offsets.back());
+            std::vector<std::uint32_t> fill(edge_offsets.begin(), edge_offsets.end() - 1);
+            for (sc_hw_graph::node_id n = 0; n < size; n++) {
+                for (std::size_t i = 0; i < g.input_count(n); i++) {
+                    edges[fill[g.input(n, i).id]++] = edge{n, std::uint32_t(i), term(0, input_position + i)};
+                }
+            }
+        }
+
+        void set_coefficient(sc_hw_graph::node_id n, std::size_t k, double c) {
+            double old = g.coefficient(n, k);
+            if (old == c) {
+                return;
+            }
+            g.set_coefficient(n, k, c);
+            terms[n] += coefficient_term(c, k) - coefficient_term(old, k);
+            dirty[n] = 1;
+            first_dirty = std::min(first_dirty, n);
+        }
+
+        // Subtree hash of every node, indexed by node id
+        const std::vector<hash>& hashes() {
+            rehash();
+            return node_hashes;
+        }
+
+        // Makes the given outputs of g valid. Walking back from their nodes,
+        // a node found in the cache is loaded and its subtree is not
+        // visited; all other visited nodes are evaluated and stored.
+        statistics evaluate(const std::vector<sc_hw_graph::value>& outputs) {
+            statistics s;
+            s.hashed = rehash();
+
+            visited.clear();
+            missing.clear();
+            for (auto v : outputs) {
+                need(owner[v.id]);
+            }
+
+            // Every node is visited once, after it was first needed
+            for (std::size_t i = 0; i < visited.size(); i++) {
+                sc_hw_graph::node_id n = visited[i];
+
+                // asil_class reads the residual input of the node
+                if (g.node_kind(n) == sc_hw_graph::kind::asil) {
+                    need(owner[g.input(n, 0).id]);
+                }
+
+                if (valid[n] && valid_hashes[n] == node_hashes[n]) {
+                    s.current++;
+                    continue;
+                }
+
+                const std::vector<double>* cached = cache.find(node_hashes[n]);
+
+                if (cached != nullptr && cached->size() == g.output_count(n)) {
+                    for (std::size_t k = 0; k < cached->size(); k++) {
+                        g.write(g.output(n, k), (*cached)[k]);
+                    }
+                    validate(n);
+                    s.loaded++;
+                    continue;
+                }
+
+                for (std::size_t j = 0; j < g.input_count(n); j++) {
+                    need(owner[g.input(n, j).id]);
+                }
+                missing.push_back(n);
+            }
+
+            for (auto n : visited) {
+                needed[n] = 0;
+            }
+
+            std::sort(missing.begin(), missing.end());
+            g.evaluate(missing);
+
+            for (auto n : missing) {
+                values.clear();
+                for (std::size_t k = 0; k < g.output_count(n); k++) {
+                    values.push_back(g.read(g.output(n, k)));
+                }
+                cache.put(node_hashes[n], values);
+                validate(n);
+            }
+
+            s.evaluated = missing.size();
+            s.skipped = g.size() - s.evaluated - s.loaded - s.current;
+            return s;
+        }
+
+    private:
+
+        // Input at the given position of a node and its current term
+        struct edge
+        {
+            sc_hw_graph::node_id node;
+            std::uint32_t position;
+            hash term;
+        };
+
+        sc_hw_graph::graph& g;
+        store& cache;
+        std::vector<hash> headers;
+        std::vector<hash> terms;
+        std::vector<hash> node_hashes;
+        std::vector<hash> value_hashes;
+        std::vector<hash> valid_hashes; // node hash of the outputs in g
+        std::vector<char> valid;
+        std::vector<sc_hw_graph::node_id> owner;
+        std::vector<std::uint32_t> edge_offsets;
+        std::vector<edge> edges;
+        std::vector<char> dirty;
+        std::vector<char> needed;
+        sc_hw_graph::node_id first_dirty;
+        bool complete = false; // all hashes were computed once
+        std::vector<sc_hw_graph::node_id> visited;
+        std::vector<sc_hw_graph::node_id> missing;
+        std::vector<double> values;
+
+        void validate(sc_hw_graph::node_id n) {
+            valid[n] = 1;
+            valid_hashes[n] = node_hashes[n];
+        }
+
+        void need(sc_hw_graph::node_id n) {
+            if (!needed[n]) {
+                needed[n] = 1;
+                visited.push_back(n);
+            }
+        }
+
+        // Hashes the marked nodes in topological order, returns their number
+        std::size_t rehash() {
+            std::size_t count = 0;
+
+            for (sc_hw_graph::node_id n = first_dirty; n < g.size(); n++) {
+                if (!dirty[n]) {
+                    continue;
+                }
+                dirty[n] = 0;
+                count++;
+
+                hash h = node_hash(headers[n], terms[n]);
+                if (h == node_hashes[n] && complete) {
+                    continue;
+                }
+                node_hashes[n] = h;
+
+                for (std::size_t k = 0; k < g.output_count(n); k++) {
+                    std::uint32_t v = g.output(n, k).id;
+                    value_hashes[v] = output_hash(h, k);
+                    for (std::uint32_t e = edge_offsets[v]; e < edge_offsets[v + 1]; e++) {
+                        edge& to = edges[e];
+                        hash t = term(value_hashes[v], input_position + to.position);
+                        terms[to.node] += t - to.term;
+                        to.term = t;
+                        dirty[to.node] = 1;
+                    }
+                }
+            }
+
+            first_dirty = g.size();
+            complete = true;
+            return count;
+        }
+    };
+
+    // Cached evaluation that hashes the whole graph first, for a single
+    // evaluation. Repeated evaluations use a cached_graph.
+    inline statistics evaluate(sc_hw_graph::graph& g, store& cache, const std::vector<sc_hw_graph::value>& outputs)
+    {
+        return cached_graph(g, cache).evaluate(outputs);
+    }
+}
+
+#endif // SC_HW_CACHE_H
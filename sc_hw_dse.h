@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_DSE_H
+#define SC_HW_DSE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+#include "sc_hw_metrics.h"
+#include "sc_hw_metrics_interval.h"
+#include "sc_parallel.h"
+
+// Design-space exploration over safety mechanism configurations. A catalog
+// lists the mechanisms of a model, each with alternative options (including
+// "none") that set some coefficients of the graph and have a cost. The
+// configurations are searched depth first, one mechanism after the other.
+// Mechanisms that are not decided yet take the hull of the values of their
+// options, so one evaluation of the interval graph bounds the metrics of
+// all configurations below. A branch whose best possible ASIL is below the
+// target is pruned. The subtrees of the first mechanisms are searched in
+// parallel, each on its own graph.
+
+namespace sc_hw_dse {
+
+    using sc_hw_metrics_interval::interval;
+    using sc_hw_graph::interval_graph;
+    using sc_hw_graph::node_id;
+    using sc_hw_graph::parameter;
+
+
+    // One alternative of a mechanism, values has one entry per parameter
+    struct option
+    {
+        std::string name;
+        double cost;
+        std::vector<double> values;
+    };
+
+    struct mechanism
+    {
+        std::string name;
+        std::vector<parameter> parameters;
+        std::vector<option> options;
+    };
+
+    // Chosen option per mechanism and the resulting metrics
+    struct configuration
+    {
+        std::vector<std::size_t> choices;
+        double cost;
+        double spfm;
+        double lfm;
+        int asil_class;
+    };
+
+    struct result
+    {
+        std::vector<configuration> pareto; // by ascending cost
+        std::size_t configurations = 0;    // size of the design space
+        std::size_t feasible = 0;          // configurations that reach the target
+        std::size_t evaluated = 0;         // graph evaluations
+        std::size_t pruned = 0;            // configurations never evaluated
+    };
+
+    class explorer {
+
+    public:
+
+        // build adds the model to an empty graph, asil is the name of its ASIL node
+        explorer(std::function<void(interval_graph&)> build,
+                 const std::string& asil,
+                 std::vector<mechanism> catalog) : build(std::move(build)),
+                                                   asil(asil),
+                                                   catalog(std::move(catalog))
+        {
+            for (auto& m : this->catalog) {
+                sc_assert(!m.options.empty());
+                for (auto& o : m.options) {
+                    sc_assert(o.values.size() == m.parameters.size());
+                }
+            }
+        }
+
+        // Pareto front of cost versus SPFM and LFM over all configurations
+        // whose ASIL is at least target (an index into asil_levels)
+        result explore(int target, sc_parallel::thread_pool& pool) const {
+            result r;
+            r.configurations = leaves(0);
+
+            // Deep enough for all threads to be busy
+            std::size_t depth = 0;
+            std::size_t tasks = 1;
+            while (pool.size() > 1 && depth < catalog.size() && tasks < 4 * pool.size()) {
+                tasks *= catalog[depth].options.size();
+                depth++;
+            }
+
+            search_state root = make_state(target);
+            for (std::size_t m = 0; m < catalog.size(); m++) {
+                apply_hull(root, m);
+            }
+            search(root, 0, depth, pool);
+
+            r.evaluated = root.evaluated;
+            r.pruned = root.pruned;
+            r.feasible = root.feasible.size();
+            r.pareto = pareto_front(std::move(root.feasible));
+            return r;
+        }
+        // "mechanism=option, ..." for a configuration
+        std::string describe(const configuration& c) const {
+            std::string s;
+            for (std::size_t m = 0; m < catalog.size(); m++) {
+                s += (m == 0 ? "" : ", ") + catalog[m].name + "=" + catalog[m].options[c.choices[m]].name;
+            }
+            return s;
+        }
+
+        const std::vector<mechanism>& mechanisms() const {
+            return catalog;
+        }
+
+        // Configurations that are not dominated in cost, SPFM and LFM, by
+        // ascending cost
+        static std::vector<configuration> pareto_front(std::vector<configuration> c) {
+            std::stable_sort(c.begin(), c.end(), [](const configuration& a, const configuration& b) {
+                if (a.cost != b.cost) {
+                    return a.cost < b.cost;
+                }
+                return (a.spfm != b.spfm) ? a.spfm > b.spfm : a.lfm > b.lfm;
+            });
+
+            std::vector<configuration> front;
+            for (auto& candidate : c) {
+                bool dominated = false;
+                for (auto& f : front) {
+                    if (f.spfm >= candidate.spfm && f.lfm >= candidate.lfm) {
+                        dominated = true;
+                        break;
+                    }
+                }
+                if (!dominated) {
+                    front.push_back(candidate);
+                }
+            }
+            return front;
+        }
+
+    private:
+
+        struct search_state
+        {
+            std::unique_ptr<interval_graph> g;
+            std::vector<std::vector<node_id>> nodes;
+            node_id asil = 0;
+            int target = 0;
+            std::vector<std::size_t> choices;
+            std::vector<configuration> feasible;
+            std::size_t evaluated = 0;
+            std::size_t pruned = 0;
+        };
+
+        std::function<void(interval_graph&)> build;
+        std::string asil;
+        std::vector<mechanism> catalog;
+
+        search_state make_state(int target) const {
+            search_state s;
+            s.g = std::make_unique<interval_graph>();
+            build(*s.g);
+            s.g->compile();
+            s.nodes = resolve(*s.g);
+            s.asil = s.g->find(asil);
+            s.target = target;
+            s.choices.assign(catalog.size(), 0);
+
+            if (s.asil == s.g->size()) {
+                SC_REPORT_FATAL("DSE", ("No ASIL node " + asil).c_str());
+            }
+            return s;
+        }
+
+        std::vector<std::vector<node_id>> resolve(const interval_graph& g) const {
+            std::vector<std::vector<node_id>> nodes;
+            for (auto& m : catalog) {
+                nodes.emplace_back();
+                for (auto& p : m.parameters) {
+                    node_id n = g.find(p.node);
+                    if (n == g.size() || p.index >= g.coefficient_count(n)) {
+                        SC_REPORT_FATAL("DSE", ("No parameter " + p.node + "[" + std::to_string(p.index) + "]").c_str());
+                    }
+                    nodes.back().push_back(n);
+                }
+            }
+            return nodes;
+        }
+
+        std::size_t leaves(std::size_t depth) const {
+            std::size_t n = 1;
+            for (std::size_t m = depth; m < catalog.size(); m++) {
+                n *= catalog[m].options.size();
+            }
+            return n;
+        }
+
+        void apply_option(search_state& s, std::size_t m, std::size_t o) const {
+            auto& p = catalog[m].parameters;
+            for (std::size_t i = 0; i < p.size(); i++) {
+                s.g->set_coefficient(s.nodes[m][i], p[i].index, catalog[m].options[o].values[i]);
+            }
+        }
+
+        void apply_hull(search_state& s, std::size_t m) const {
+            auto& p = catalog[m].parameters;
+            for (std::size_t i = 0; i < p.size(); i++) {
+                interval hull = catalog[m].options[0].values[i];
+                for (auto& o : catalog[m].options) {
+                    hull = interval::hull(hull, o.values[i]);
+                }
+                s.g->set_coefficient(s.nodes[m][i], p[i].index, hull);
+            }
+        }
+
+        // The options of mechanisms above parallel_depth are searched in
+        // parallel, each on a new graph
+        void search(search_state& s, std::size_t depth, std::size_t parallel_depth, sc_parallel::thread_pool& pool) const {
+            s.g->evaluate();
+            s.evaluated++;
+
+            if (depth == catalog.size()) {
+                configuration c{s.choices, 0.0, s.g->spfm(s.asil).lower, s.g->lfm(s.asil).lower, s.g->asil_class(s.asil)};
+                for (std::size_t m = 0; m < catalog.size(); m++) {
+                    c.cost += catalog[m].options[s.choices[m]].cost;
+                }
+                if (c.asil_class >= s.target) {
+                    s.feasible.push_back(c);
+                }
+                return;
+            }
+
+            if (s.g->possible_class(s.asil) < s.target) {
+                s.pruned += leaves(depth);
+                return;
+            }
+
+            if (depth < parallel_depth) {
+                std::vector<search_state> children(catalog[depth].options.size());
+
+                pool.parallel_for(children.size(), [&](std::size_t o) {
+                    search_state& c = children[o];
+                    c = make_state(s.target);
+                    c.choices = s.choices;
+                    c.choices[depth] = o;
+                    for (std::size_t m = 0; m < catalog.size(); m++) {
+                        if (m <= depth) {
+                            apply_option(c, m, c.choices[m]);
+                        } else {
+                            apply_hull(c, m);
+                        }
+                    }
+                    search(c, depth + 1, parallel_depth, pool);
+                });
+
+                for (auto& c : children) {
+                    s.evaluated += c.evaluated;
+                    s.pruned += c.pruned;
+                    s.feasible.insert(s.feasible.end(), c.feasible.begin(), c.feasible.end());
+                }
+                return;
+            }
+
+            for (std::size_t o = 0; o < catalog[depth].options.size(); o++) {
+                s.choices[depth] = o;
+                apply_option(s, depth, o);
+                search(s, depth + 1, parallel_depth, pool);
+            }
+            apply_hull(s, depth);
+        }
+    };
+}
+
+#endif // SC_HW_DSE_H
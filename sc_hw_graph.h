@@ -0,0 +1,1100 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_GRAPH_H
+#define SC_HW_GRAPH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_metrics.h"
+#include "sc_hw_metrics_interval.h"
+#include "sc_parallel.h"
+
+// Graph backend for the sc_hw_metrics primitives. Instead of one module and
+// several signals per node, a model is a flat structure of arrays: node kinds,
+// CSR offsets into input and coefficient arrays and one buffer with a rate per
+// node output. The builder only accepts inputs that already exist, so the
+// nodes are stored in topological order and evaluate() is a single linear
+// scan. compile() moves all arrays into one arena allocation.
+//
+// For parallel evaluation the nodes are grouped into levels: a node's level
+// is one above the highest level of its inputs, so all nodes of a level are
+// independent. Each node is always computed by one thread with the same
+// code. Sums are added as in the SystemC backends, wide ones with
+// sc_hw_metrics::pairwise_sum, whose subtrees of up to sum_block inputs
+// a pool adds in parallel and combines in the same order. Results are
+// therefore bit-identical for any number of threads and to the modules.
+//
+// A compiled graph is not changed by evaluating an instance of it, which
+// holds its own coefficients and values. Independent scenarios can thereby
+// run concurrently on one shared model without any global state.
+//
+// Replicas of one sub-model, e.g. identical memory channels, share the graph
+// and its coefficients as well. Only their values are per replica, and every
+// node is evaluated for all replicas in one loop.
+
+namespace sc_hw_graph {
+
+    enum class kind : std::uint8_t {
+        basic_event, // coefficients: rate,  outputs: output
+        coverage,    // coefficients: dc lc, outputs: output latent
+        split,       // coefficients: rates, outputs: one per rate
+        sum,         // coefficients: -,     outputs: output
+        asil         // coefficients: -,     outputs: spfm lfm, inputs: residual latent total
+    };
+
+    using node_id = std::uint32_t;
+
+    // Inputs of a sum that are added up by one task
+    static const std::size_t sum_block = 4096;
+
+    // Sum of the inputs in[0..count) of values with replicas stride apart,
+    // wide ones pairwise like sc_hw_metrics::sum
+    inline double sum_inputs(const std::uint32_t* in, std::size_t count, const double* values, std::size_t stride = 1)
+    {
+        if (count < std::size_t(sc_hw_metrics::wide_sum_threshold)) {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < count; i++) {
+                sum += values[in[i] * stride];
+            }
+            return sum;
+        }
+
+        thread_local std::vector<double> buffer;
+        buffer.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            buffer[i] = values[in[i] * stride];
+        }
+        return sc_hw_metrics::pairwise_sum(buffer.data(), count);
+    }
+
+    // Intervals are added in input order like sc_hw_metrics_interval::sum
+    inline sc_hw_metrics_interval::interval sum_inputs(const std::uint32_t* in, std::size_t count,
+                                                       const sc_hw_metrics_interval::interval* values,
+                                                       std::size_t stride = 1)
+    {
+        sc_hw_metrics_interval::interval sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum = sum + values[in[i] * stride];
+        }
+        return sum;
+    }
+
+    // The subtrees of pairwise_sum with at most sum_block values, from left
+    // to right
+    inline void pairwise_leaves(const double* x, std::size_t count, std::vector<std::pair<const double*, std::size_t>>& leaves)
+    {
+        if (count > sum_block) {
+            std::size_t half = sc_hw_metrics::pairwise_half(count);
+            pairwise_leaves(x, half, leaves);
+            pairwise_leaves(x + half, count - half, leaves);
+        } else {
+            leaves.emplace_back(x, count);
+        }
+    }
+
+    inline double pairwise_combine(std::size_t count, const std::vector<double>& sums, std::size_t& leaf)
+    {
+        if (count > sum_block) {
+            std::size_t half = sc_hw_metrics::pairwise_half(count);
+            double left = pairwise_combine(half, sums, leaf);
+            return left + pairwise_combine(count - half, sums, leaf);
+        }
+        return sums[leaf++];
+    }
+
+    // pairwise_sum of a wide sum with its subtrees added on the pool
+    inline double parallel_sum(const std::vector<double>& x, sc_parallel::thread_pool& pool)
+    {
+        std::vector<std::pair<const double*, std::size_t>> leaves;
+        pairwise_leaves(x.data(), x.size(), leaves);
+
+        std::vector<double> sums(leaves.size());
+        pool.parallel_for(leaves.size(), [&](std::size_t l) {
+            sums[l] = sc_hw_metrics::pairwise_sum(leaves[l].first, leaves[l].second);
+        });
+
+        std::size_t leaf = 0;
+        return pairwise_combine(x.size(), sums, leaf);
+    }
+
+    inline sc_hw_metrics_interval::interval parallel_sum(const std::vector<sc_hw_metrics_interval::interval>& x,
+                                                         sc_parallel::thread_pool&)
+    {
+        sc_hw_metrics_interval::interval sum = 0.0;
+        for (auto& v : x) {
+            sum = sum + v;
+        }
+        return sum;
+    }
+
+    // Handle of one node output
+    struct value
+    {
+        std::uint32_t id;
+    };
+
+    struct coverage_outputs
+    {
+        value output;
+        value latent;
+    };
+
+    // Coefficient index of the named node, e.g. {"DRAM_SEC_DED.RES_MBE_COV", 0}
+    // for the diagnostic coverage of that coverage node
+    struct parameter
+    {
+        std::string node;
+        std::size_t index;
+    };
+
+    // One contiguous block from which all arrays of a graph are allocated
+    class arena {
+
+    public:
+
+        arena() = default;
+
+        explicit arena(std::size_t capacity) : data(new std::byte[capacity]), capacity(capacity) {}
+
+        template <class T>
+        T* allocate(std::size_t n) {
+            static_assert(std::is_trivially_destructible_v<T>);
+            offset = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+            sc_assert(offset + n * sizeof(T) <= capacity);
+            T* p = reinterpret_cast<T*>(data.get() + offset);
+            offset += n * sizeof(T);
+            return p;
+        }
+
+        template <class T>
+        static std::size_t bytes(std::size_t n) {
+            return n * sizeof(T) + alignof(T);
+        }
+
+        std::size_t size() const {
+            return capacity;
+        }
+
+    private:
+
+        std::unique_ptr<std::byte[]> data;
+        std::size_t capacity = 0;
+        std::size_t offset = 0;
+    };
+
+    inline void asil_metrics(double residual, double latent, double total, double& spfm, double& lfm)
+    {
+        spfm = 100 * (1 - (residual / total));
+        lfm = 100 * (1 - (latent / (total - residual)));
+    }
+
+    inline void asil_metrics(const sc_hw_metrics_interval::interval& residual,
+                             const sc_hw_metrics_interval::interval& latent,
+                             const sc_hw_metrics_interval::interval& total,
+                             sc_hw_metrics_interval::interval& spfm,
+                             sc_hw_metrics_interval::interval& lfm)
+    {
+        spfm = sc_hw_metrics_interval::interval(100 * (1 - (residual.upper / total.lower)),
+                                                100 * (1 - (residual.lower / total.upper)));
+        lfm = sc_hw_metrics_interval::lfm_interval(residual, latent, total);
+    }
+
+    inline double lower(double d) { return d; }
+    inline double upper(double d) { return d; }
+    inline double lower(const sc_hw_metrics_interval::interval& i) { return i.lower; }
+    inline double upper(const sc_hw_metrics_interval::interval& i) { return i.upper; }
+
+    template <class T>
+    class basic_instance;
+
+    template <class T>
+    class basic_replicas;
+
+    template <class T>
+    class basic_graph {
+
+        friend class basic_instance<T>;
+        friend class basic_replicas<T>;
+
+    public:
+
+        // Builder
+
+        value basic_event(const std::string& name, T rate) {
+            node_id n = add_node(kind::basic_event, name, 1);
+            coefficients.push_back(rate);
+            coef_offsets.push_back(coefficients.size());
+            return value{out_offsets[n]};
+        }
+
+        coverage_outputs coverage(const std::string& name, value input, T dc, T lc) {
+            sc_assert((lower(dc) >= 0.0) && (upper(dc) <= 1.0));
+            sc_assert((lower(lc) >= 0.0) && (upper(lc) <= 1.0));
+            add_input(input);
+            node_id n = add_node(kind::coverage, name, 2);
+            coefficients.push_back(dc);
+            coefficients.push_back(lc);
+            coef_offsets.push_back(coefficients.size());
+            return coverage_outputs{value{out_offsets[n]}, value{out_offsets[n] + 1}};
+        }
+
+        std::vector<value> split(const std::string& name, value input, std::initializer_list<T> rates) {
+            return split(name, input, std::vector<T>(rates));
+        }
+
+        std::vector<value> split(const std::string& name, value input, const std::vector<T>& rates) {
+            T total_rate = 0.0;
+
+            for (auto& r : rates) {
+                total_rate = total_rate + r;
+            }
+
+            if (lower(total_rate) > 1.0)
+            {
+                std::cout << name << " " << total_rate << " ";
+                SC_REPORT_FATAL("SPLIT", "Total Rate greater than 100%");
+            }
+
+            add_input(input);
+            node_id n = add_node(kind::split, name, rates.size());
+            coefficients.insert(coefficients.end(), rates.begin(), rates.end());
+            coef_offsets.push_back(coefficients.size());
+
+            std::vector<value> outputs;
+            for (std::uint32_t i = 0; i < rates.size(); i++) {
+                outputs.push_back(value{out_offsets[n] + i});
+            }
+            return outputs;
+        }
+
+        value sum(const std::string& name, std::initializer_list<value> inputs) {
+            return sum(name, std::vector<value>(inputs));
+        }
+
+        value sum(const std::string& name, const std::vector<value>& inputs) {
+            sc_assert(!inputs.empty());
+            for (auto& i : inputs) {
+                add_input(i);
+            }
+            node_id n = add_node(kind::sum, name, 1);
+            coef_offsets.push_back(coefficients.size());
+            return value{out_offsets[n]};
+        }
+
+        value pass(const std::string& name, value input) {
+            return sum(name, {input});
+        }
+
+        node_id asil(const std::string& name, value residual, value latent, value total) {
+            add_input(residual);
+            add_input(latent);
+            add_input(total);
+            node_id n = add_node(kind::asil, name, 2);
+            coef_offsets.push_back(coefficients.size());
+            return n;
+        }
+
+        // Moves all arrays into one arena. The structure is fixed afterwards,
+        // coefficients can still be changed.
+        void compile() {
+            if (compiled()) {
+                return;
+            }
+
+            std::size_t n = kinds.size();
+            std::size_t bytes = arena::bytes<kind>(n)
+                              + 4 * arena::bytes<std::uint32_t>(n + 1)
+                              + arena::bytes<std::uint32_t>(inputs.size())
+                              + arena::bytes<T>(coefficients.size())
+                              + arena::bytes<T>(out_offsets.back())
+                              + arena::bytes<char>(names.size());
+
+            memory = arena(bytes);
+            c_kinds = copy(kinds);
+            c_in_offsets = copy(in_offsets);
+            c_inputs = copy(inputs);
+            c_coef_offsets = copy(coef_offsets);
+            c_coefficients = copy(coefficients);
+            c_out_offsets = copy(out_offsets);
+            c_name_offsets = copy(name_offsets);
+            c_names = copy(names);
+            c_values = memory.allocate<T>(out_offsets.back());
+            std::uninitialized_fill_n(c_values, out_offsets.back(), T(0.0));
+
+            node_count = n;
+            value_count = out_offsets.back();
+
+            release(kinds);
+            release(in_offsets);
+            release(inputs);
+            release(coef_offsets);
+            release(coefficients);
+            release(out_offsets);
+            release(name_offsets);
+            release(names);
+        }
+
+        bool compiled() const {
+            return c_kinds != nullptr;
+        }
+
+        // Evaluation
+
+        void evaluate() {
+            compile();
+
+            for (node_id n = 0; n < node_count; n++) {
+                evaluate_node(n);
+            }
+        }
+
+        // Evaluates one level after the other, the nodes of a level in
+        // chunks of grain nodes on the pool
+        void evaluate(sc_parallel::thread_pool& pool, std::size_t grain = 1024) {
+            schedule();
+
+            for (std::size_t l = 0; l + 1 < level_offsets.size(); l++) {
+                pool.parallel_for(level_offsets[l], level_offsets[l + 1], grain, [this, &pool](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; i++) {
+                        node_id n = level_nodes[i];
+
+                        if (c_kinds[n] == kind::sum && input_count(n) > sum_block) {
+                            evaluate_wide_sum(n, pool);
+                        } else {
+                            evaluate_node(n);
+                        }
+                    }
+                });
+            }
+        }
+
+        // Evaluates only the given nodes in the given order, e.g. the part
+        // of the graph whose results are not cached
+        void evaluate(const std::vector<node_id>& nodes) {
+            compile();
+
+            for (node_id n : nodes) {
+                evaluate_node(n);
+            }
+        }
+
+        // Groups the nodes into levels of mutually independent nodes
+        void schedule() {
+            compile();
+
+            if (!level_offsets.empty()) {
+                return;
+            }
+
+            std::vector<std::uint32_t> value_level(value_count, 0);
+            std::vector<std::uint32_t> node_level(node_count, 0);
+            std::uint32_t max_level = 0;
+
+            for (node_id n = 0; n < node_count; n++) {
+                std::uint32_t level = 0;
+                for (std::size_t i = c_in_offsets[n]; i < c_in_offsets[n + 1]; i++) {
+                    level = std::max(level, value_level[c_inputs[i]] + 1);
+                }
+                for (std::size_t v = c_out_offsets[n]; v < c_out_offsets[n + 1]; v++) {
+                    value_level[v] = level;
+                }
+                node_level[n] = level;
+                max_level = std::max(max_level, level);
+            }
+
+            level_offsets.assign(max_level + 2, 0);
+            for (node_id n = 0; n < node_count; n++) {
+                level_offsets[node_level[n] + 1]++;
+            }
+            for (std::size_t l = 1; l < level_offsets.size(); l++) {
+                level_offsets[l] += level_offsets[l - 1];
+            }
+
+            std::vector<std::uint32_t> fill(level_offsets.begin(), level_offsets.end() - 1);
+            level_nodes.resize(node_count);
+            for (node_id n = 0; n < node_count; n++) {
+                level_nodes[fill[node_level[n]]++] = n;
+            }
+        }
+
+        std::size_t levels() const {
+            return level_offsets.empty() ? 0 : level_offsets.size() - 1;
+        }
+
+        T read(value v) const {
+            sc_assert(compiled());
+            return c_values[v.id];
+        }
+
+        void write(value v, T x) {
+            sc_assert(compiled());
+            c_values[v.id] = x;
+        }
+
+        // Values of all node outputs, indexed by value id
+        const T* data() const {
+            sc_assert(compiled());
+            return c_values;
+        }
+
+        T spfm(node_id asil) const {
+            return c_values[c_out_offsets[asil]];
+        }
+
+        T lfm(node_id asil) const {
+            return c_values[c_out_offsets[asil] + 1];
+        }
+
+        // ASIL level that holds for all parameters (for double the only one)
+        std::string asil_level(node_id asil) const {
+            return sc_hw_metrics::asil_levels[asil_class(asil)];
+        }
+
+        int asil_class(node_id asil) const {
+            T res = c_values[c_inputs[c_in_offsets[asil]]];
+            return sc_hw_metrics::asil_class(lower(spfm(asil)), lower(lfm(asil)), upper(res));
+        }
+
+        // ASIL level that is reached for the best parameters in the box
+        std::string possible_level(node_id asil) const {
+            return sc_hw_metrics::asil_levels[possible_class(asil)];
+        }
+
+        int possible_class(node_id asil) const {
+            T res = c_values[c_inputs[c_in_offsets[asil]]];
+            return sc_hw_metrics::asil_class(upper(spfm(asil)), upper(lfm(asil)), lower(res));
+        }
+
+        // Parameters
+
+        T coefficient(node_id n, std::size_t k) const {
+            sc_assert(compiled() && c_coef_offsets[n] + k < c_coef_offsets[n + 1]);
+            return c_coefficients[c_coef_offsets[n] + k];
+        }
+
+        void set_coefficient(node_id n, std::size_t k, T c) {
+            sc_assert(compiled() && c_coef_offsets[n] + k < c_coef_offsets[n + 1]);
+            c_coefficients[c_coef_offsets[n] + k] = c;
+        }
+
+        // Structure
+
+        std::size_t size() const {
+            return compiled() ? node_count : kinds.size();
+        }
+
+        std::size_t values() const {
+            return compiled() ? value_count : out_offsets.back();
+        }
+
+        std::size_t memory_bytes() const {
+            return memory.size();
+        }
+
+        kind node_kind(node_id n) const {
+            return c_kinds[n];
+        }
+
+        std::string name(node_id n) const {
+            return std::string(c_names + c_name_offsets[n], c_name_offsets[n + 1] - c_name_offsets[n]);
+        }
+
+        // Index of the node with the given name, size() if there is none
+        node_id find(const std::string& name) const {
+            for (node_id n = 0; n < node_count; n++) {
+                std::size_t length = c_name_offsets[n + 1] - c_name_offsets[n];
+                if (length == name.size() && std::memcmp(c_names + c_name_offsets[n], name.data(), length) == 0) {
+                    return n;
+                }
+            }
+            return node_count;
+        }
+
+        value output(node_id n, std::size_t k = 0) const {
+            sc_assert(c_out_offsets[n] + k < c_out_offsets[n + 1]);
+            return value{static_cast<std::uint32_t>(c_out_offsets[n] + k)};
+        }
+
+        std::size_t output_count(node_id n) const {
+            return c_out_offsets[n + 1] - c_out_offsets[n];
+        }
+
+        std::size_t input_count(node_id n) const {
+            return c_in_offsets[n + 1] - c_in_offsets[n];
+        }
+
+        value input(node_id n, std::size_t k) const {
+            sc_assert(c_in_offsets[n] + k < c_in_offsets[n + 1]);
+            return value{c_inputs[c_in_offsets[n] + k]};
+        }
+
+        std::size_t coefficient_count(node_id n) const {
+            return c_coef_offsets[n + 1] - c_coef_offsets[n];
+        }
+
+    protected:
+
+        void evaluate_node(node_id n) {
+            evaluate_node(n, c_coefficients, c_values);
+        }
+
+        // Evaluates node n on the given coefficient and value arrays, which
+        // are laid out like the graph's own
+        void evaluate_node(node_id n, const T* coefficients, T* values) const {
+            T* out = values + c_out_offsets[n];
+            const T* coef = coefficients + c_coef_offsets[n];
+            const std::uint32_t* in = c_inputs + c_in_offsets[n];
+            std::uint32_t in_count = c_in_offsets[n + 1] - c_in_offsets[n];
+
+            switch (c_kinds[n]) {
+                case kind::basic_event:
+                    out[0] = coef[0];
+                    break;
+                case kind::coverage: {
+                    T input = values[in[0]];
+                    out[0] = input * (1.0 - coef[0]);
+                    out[1] = input * (1.0 - coef[1]);
+                    break;
+                }
+                case kind::split: {
+                    T input = values[in[0]];
+                    std::uint32_t out_count = c_out_offsets[n + 1] - c_out_offsets[n];
+                    for (std::uint32_t i = 0; i < out_count; i++) {
+                        out[i] = input * coef[i];
+                    }
+                    break;
+                }
+                case kind::sum:
+                    out[0] = sum_inputs(in, in_count, values);
+                    break;
+                case kind::asil:
+                    asil_metrics(values[in[0]], values[in[1]], values[in[2]], out[0], out[1]);
+                    break;
+            }
+        }
+
+        void evaluate_wide_sum(node_id n, sc_parallel::thread_pool& pool) {
+            const std::uint32_t* in = c_inputs + c_in_offsets[n];
+            std::vector<T> x(input_count(n));
+
+            pool.parallel_for(0, x.size(), sum_block, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    x[i] = c_values[in[i]];
+                }
+            });
+
+            c_values[c_out_offsets[n]] = parallel_sum(x, pool);
+        }
+
+        // Build phase
+        std::vector<kind> kinds;
+        std::vector<std::uint32_t> in_offsets{0};
+        std::vector<std::uint32_t> inputs;
+        std::vector<std::uint32_t> coef_offsets{0};
+        std::vector<T> coefficients;
+        std::vector<std::uint32_t> out_offsets{0};
+        std::vector<std::uint32_t> name_offsets{0};
+        std::vector<char> names;
+
+        // Compiled, all pointing into memory
+        arena memory;
+        std::size_t node_count = 0;
+        std::size_t value_count = 0;
+        kind* c_kinds = nullptr;
+        std::uint32_t* c_in_offsets = nullptr;
+        std::uint32_t* c_inputs = nullptr;
+        std::uint32_t* c_coef_offsets = nullptr;
+        T* c_coefficients = nullptr;
+        std::uint32_t* c_out_offsets = nullptr;
+        std::uint32_t* c_name_offsets = nullptr;
+        char* c_names = nullptr;
+        T* c_values = nullptr;
+
+        // Level schedule for parallel evaluation
+        std::vector<std::uint32_t> level_offsets;
+        std::vector<node_id> level_nodes;
+
+    private:
+
+        void add_input(value v) {
+            if (compiled()) {
+                SC_REPORT_FATAL("GRAPH", "Nodes cannot be added to a compiled graph");
+            }
+            sc_assert(v.id < out_offsets.back());
+            inputs.push_back(v.id);
+        }
+
+        node_id add_node(kind k, const std::string& name, std::uint32_t outputs) {
+            if (compiled()) {
+                SC_REPORT_FATAL("GRAPH", "Nodes cannot be added to a compiled graph");
+            }
+            kinds.push_back(k);
+            in_offsets.push_back(inputs.size());
+            out_offsets.push_back(out_offsets.back() + outputs);
+            names.insert(names.end(), name.begin(), name.end());
+            name_offsets.push_back(names.size());
+            return kinds.size() - 1;
+        }
+
+        template <class U>
+        U* copy(const std::vector<U>& v) {
+            U* p = memory.allocate<U>(v.size());
+            std::uninitialized_copy(v.begin(), v.end(), p);
+            return p;
+        }
+
+        template <class U>
+        static void release(std::vector<U>& v) {
+            std::vector<U>().swap(v);
+        }
+    };
+
+    // Evaluation state of a compiled graph: a copy of its coefficients and
+    // one value per node output. The graph itself is only read, so any number
+    // of instances of one graph can be evaluated on different threads at the
+    // same time, each with its own parameters.
+    template <class T>
+    class basic_instance {
+
+    public:
+
+        explicit basic_instance(const basic_graph<T>& g) : g(g)
+        {
+            sc_assert(g.compiled());
+            coefficients.assign(g.c_coefficients, g.c_coefficients + g.c_coef_offsets[g.node_count]);
+            values.assign(g.value_count, T(0.0));
+        }
+
+        const basic_graph<T>& model() const {
+            return g;
+        }
+
+        void evaluate() {
+            for (node_id n = 0; n < g.node_count; n++) {
+                g.evaluate_node(n, coefficients.data(), values.data());
+            }
+        }
+
+        T read(value v) const {
+            return values[v.id];
+        }
+
+        void write(value v, T x) {
+            values[v.id] = x;
+        }
+
+        const T* data() const {
+            return values.data();
+        }
+
+        T spfm(node_id asil) const {
+            return values[g.c_out_offsets[asil]];
+        }
+
+        T lfm(node_id asil) const {
+            return values[g.c_out_offsets[asil] + 1];
+        }
+
+        std::string asil_level(node_id asil) const {
+            return sc_hw_metrics::asil_levels[asil_class(asil)];
+        }
+
+        int asil_class(node_id asil) const {
+            T res = values[g.c_inputs[g.c_in_offsets[asil]]];
+            return sc_hw_metrics::asil_class(lower(spfm(asil)), lower(lfm(asil)), upper(res));
+        }
+
+        T coefficient(node_id n, std::size_t k) const {
+            sc_assert(g.c_coef_offsets[n] + k < g.c_coef_offsets[n + 1]);
+            return coefficients[g.c_coef_offsets[n] + k];
+        }
+
+        void set_coefficient(node_id n, std::size_t k, T c) {
+            sc_assert(g.c_coef_offsets[n] + k < g.c_coef_offsets[n + 1]);
+            coefficients[g.c_coef_offsets[n] + k] = c;
+        }
+
+    private:
+
+        const basic_graph<T>& g;
+        std::vector<T> coefficients;
+        std::vector<T> values;
+    };
+
+    // Values of count replicas of a compiled graph that share its structure
+    // and coefficients. The values are stored node output by node output
+    // with the replicas contiguous. Basic events can be given a rate per
+    // replica; a replica computes the same values as an instance with these
+    // rates.
+    template <class T>
+    class basic_replicas {
+
+    public:
+
+        basic_replicas(const basic_graph<T>& g, std::size_t count) : g(g),
+                                                                     count(count),
+                                                                     rate_rows(g.node_count, -1)
+        {
+            sc_assert(g.compiled() && count > 0);
+            values.assign(g.value_count * count, T(0.0));
+        }
+
+        const basic_graph<T>& model() const {
+            return g;
+        }
+
+        std::size_t size() const {
+            return count;
+        }
+
+        // Overrides the rate of a basic event for one replica, the other
+        // replicas keep the graph's rate until they are set as well
+        void set_rate(node_id event, std::size_t replica, T rate) {
+            sc_assert(g.c_kinds[event] == kind::basic_event && replica < count);
+
+            if (rate_rows[event] < 0) {
+                rate_rows[event] = rates.size() / count;
+                rates.insert(rates.end(), count, g.c_coefficients[g.c_coef_offsets[event]]);
+            }
+            rates[rate_rows[event] * count + replica] = rate;
+        }
+
+        void evaluate() {
+            for (node_id n = 0; n < g.node_count; n++) {
+                evaluate_node(n);
+            }
+        }
+
+        T read(value v, std::size_t replica) const {
+            return values[v.id * count + replica];
+        }
+
+        // The values of all replicas
+        const T* data(value v) const {
+            return values.data() + v.id * count;
+        }
+
+        // Sum over the replicas
+        T total(value v) const {
+            T sum = 0.0;
+            for (std::size_t r = 0; r < count; r++) {
+                sum = sum + values[v.id * count + r];
+            }
+            return sum;
+        }
+
+        // Bytes of the per-replica state, the graph is shared
+        std::size_t memory_bytes() const {
+            return (values.capacity() + rates.capacity()) * sizeof(T)
+                 + rate_rows.capacity() * sizeof(std::int32_t);
+        }
+
+    private:
+
+        const basic_graph<T>& g;
+        std::size_t count;
+        std::vector<T> values;
+        std::vector<std::int32_t> rate_rows; // per node, row in rates or -1
+        std::vector<T> rates;
+
+        void evaluate_node(node_id n) {
+            T* out = values.data() + g.c_out_offsets[n] * count;
+            const T* coef = g.c_coefficients + g.c_coef_offsets[n];
+            const std::uint32_t* in = g.c_inputs + g.c_in_offsets[n];
+            std::uint32_t in_count = g.c_in_offsets[n + 1] - g.c_in_offsets[n];
+
+            switch (g.c_kinds[n]) {
+                case kind::basic_event:
+                    for (std::size_t r = 0; r < count; r++) {
+                        out[r] = (rate_rows[n] < 0) ? coef[0] : rates[rate_rows[n] * count + r];
+                    }
+                    break;
+                case kind::coverage: {
+                    const T* input = values.data() + in[0] * count;
+                    for (std::size_t r = 0; r < count; r++) {
+                        out[r] = input[r] * (1.0 - coef[0]);
+                        out[count + r] = input[r] * (1.0 - coef[1]);
+                    }
+                    break;
+                }
+                case kind::split: {
+                    const T* input = values.data() + in[0] * count;
+                    std::uint32_t out_count = g.c_out_offsets[n + 1] - g.c_out_offsets[n];
+                    for (std::uint32_t i = 0; i < out_count; i++) {
+                        for (std::size_t r = 0; r < count; r++) {
+                            out[i * count + r] = input[r] * coef[i];
+                        }
+                    }
+                    break;
+                }
+                case kind::sum:
+                    // Same order as basic_graph::evaluate_node, narrow sums
+                    // for all replicas at once
+                    if (in_count < std::uint32_t(sc_hw_metrics::wide_sum_threshold)) {
+                        std::fill(out, out + count, T(0.0));
+                        for (std::uint32_t i = 0; i < in_count; i++) {
+                            const T* input = values.data() + in[i] * count;
+                            for (std::size_t r = 0; r < count; r++) {
+                                out[r] = out[r] + input[r];
+                            }
+                        }
+                    } else {
+                        for (std::size_t r = 0; r < count; r++) {
+                            out[r] = sum_inputs(in, in_count, values.data() + r, count);
+                        }
+                    }
+                    break;
+                case kind::asil:
+                    for (std::size_t r = 0; r < count; r++) {
+                        asil_metrics(values[in[0] * count + r], values[in[1] * count + r], values[in[2] * count + r],
+                                     out[r], out[count + r]);
+                    }
+                    break;
+            }
+        }
+    };
+
+    using graph = basic_graph<double>;
+    using interval_graph = basic_graph<sc_hw_metrics_interval::interval>;
+    using instance = basic_instance<double>;
+    using interval_instance = basic_instance<sc_hw_metrics_interval::interval>;
+    using replicas = basic_replicas<double>;
+    using interval_replicas = basic_replicas<sc_hw_metrics_interval::interval>;
+
+    // Evaluates g once per row of values (rows x parameters.size(), row
+    // major), each column setting one parameter, and stores the metrics of
+    // the ASIL node. The coefficients are restored afterwards.
+    inline void evaluate_batch(graph& g, node_id asil, const std::vector<parameter>& parameters,
+                               const double* values, std::size_t rows,
+                               double* spfm, double* lfm, double* residual, double* latent)
+    {
+        g.compile();
+
+        std::vector<node_id> nodes;
+        std::vector<double> original;
+
+        for (auto& p : parameters) {
+            node_id n = g.find(p.node);
+            if (n == g.size() || p.index >= g.coefficient_count(n)) {
+                SC_REPORT_FATAL("GRAPH", ("No parameter " + p.node + "[" + std::to_string(p.index) + "]").c_str());
+            }
+            nodes.push_back(n);
+            original.push_back(g.coefficient(n, p.index));
+        }
+
+        for (std::size_t r = 0; r < rows; r++) {
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                g.set_coefficient(nodes[i], parameters[i].index, values[r * nodes.size() + i]);
+            }
+
+            g.evaluate();
+
+            spfm[r] = g.spfm(asil);
+            lfm[r] = g.lfm(asil);
+            residual[r] = g.read(g.input(asil, 0));
+            latent[r] = g.read(g.input(asil, 1));
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            g.set_coefficient(nodes[i], parameters[i].index, original[i]);
+        }
+    }
+
+    // Values of the imported channels
+    struct hierarchy_map
+    {
+        std::map<const sc_core::sc_interface*, value> values;
+
+        value operator[](const sc_core::sc_interface& channel) const {
+            auto it = values.find(&channel);
+            sc_assert(it != values.end());
+            return it->second;
+        }
+    };
+
+    // Builds the graph of all sc_hw_metrics primitives of the elaborated
+    // object hierarchy. Nodes are named like the modules. Channels that are
+    // not driven by a primitive, e.g. the outputs of a model module, become
+    // basic events with their current value. Call it after sc_start, when all
+    // port bindings are resolved.
+    inline hierarchy_map import_hierarchy(graph& g)
+    {
+        using channel = const sc_core::sc_interface*;
+
+        struct primitive
+        {
+            sc_core::sc_module* module;
+            std::vector<channel> inputs;
+            std::vector<channel> outputs;
+            bool visited;
+        };
+
+        std::vector<primitive> primitives;
+        std::map<channel, std::size_t> drivers;
+
+        std::function<void(sc_core::sc_object*)> collect = [&](sc_core::sc_object* object) {
+            primitive p{dynamic_cast<sc_core::sc_module*>(object), {}, {}, false};
+
+            if (auto* m = dynamic_cast<sc_hw_metrics::basic_event*>(object)) {
+                p.outputs = {m->output.get_interface()};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::coverage*>(object)) {
+                p.inputs = {m->input.get_interface()};
+                p.outputs = {m->output.get_interface(), (m->latent.size() != 0) ? m->latent[0] : nullptr};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::split*>(object)) {
+                p.inputs = {m->input.get_interface()};
+                for (int i = 0; i < m->outputs.size(); i++) {
+                    p.outputs.push_back(m->outputs[i]);
+                }
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::sum*>(object)) {
+                for (int i = 0; i < m->inputs.size(); i++) {
+                    p.inputs.push_back(m->inputs[i]);
+                }
+                p.outputs = {m->output.get_interface()};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::pass*>(object)) {
+                p.inputs = {m->input.get_interface()};
+                p.outputs = {m->output.get_interface()};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::asil*>(object)) {
+                p.inputs = {m->residual.get_interface(), m->latent.get_interface()};
+                if (m->total_rate.bind_count() != 0) {
+                    p.inputs.push_back(m->total_rate.get_interface());
+                }
+            } else {
+                p.module = nullptr;
+            }
+
+            if (p.module != nullptr) {
+                for (auto c : p.outputs) {
+                    if (c != nullptr) {
+                        drivers[c] = primitives.size();
+                    }
+                }
+                primitives.push_back(p);
+            }
+
+            for (auto* child : object->get_child_objects()) {
+                collect(child);
+            }
+        };
+
+        for (auto* object : sc_core::sc_get_top_level_objects()) {
+            collect(object);
+        }
+
+        hierarchy_map map;
+
+        std::function<value(channel)> resolve;
+
+        std::function<void(std::size_t)> build = [&](std::size_t index) {
+            primitive& p = primitives[index];
+
+            if (p.visited) {
+                return;
+            }
+            p.visited = true;
+
+            std::vector<value> in;
+            for (auto c : p.inputs) {
+                in.push_back(resolve(c));
+            }
+
+            std::string name = p.module->name();
+            std::vector<value> out;
+
+            if (auto* m = dynamic_cast<sc_hw_metrics::basic_event*>(p.module)) {
+                out = {g.basic_event(name, m->rate)};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::coverage*>(p.module)) {
+                auto c = g.coverage(name, in[0], m->dc, m->lc);
+                out = {c.output, c.latent};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::split*>(p.module)) {
+                out = g.split(name, in[0], m->outputs.split_rates);
+            } else if (dynamic_cast<sc_hw_metrics::sum*>(p.module)) {
+                out = {g.sum(name, in)};
+            } else if (dynamic_cast<sc_hw_metrics::pass*>(p.module)) {
+                out = {g.pass(name, in[0])};
+            } else if (auto* m = dynamic_cast<sc_hw_metrics::asil*>(p.module)) {
+                g.asil(name, in[0], in[1], (in.size() > 2) ? in[2] : g.basic_event(name + ".total", m->total));
+            }
+
+            for (std::size_t i = 0; i < p.outputs.size(); i++) {
+                if (p.outputs[i] != nullptr) {
+                    map.values[p.outputs[i]] = out[i];
+                }
+            }
+        };
+
+        resolve = [&](channel c) {
+            auto it = map.values.find(c);
+            if (it != map.values.end()) {
+                return it->second;
+            }
+
+            auto driver = drivers.find(c);
+            if (driver != drivers.end()) {
+                build(driver->second);
+                return map.values.at(c);
+            }
+
+            auto* signal = dynamic_cast<const sc_core::sc_signal_in_if<double>*>(c);
+            auto* object = dynamic_cast<const sc_core::sc_object*>(c);
+            sc_assert(signal != nullptr);
+            value v = g.basic_event(object ? object->name() : "", signal->read());
+            map.values[c] = v;
+            return v;
+        };
+
+        for (std::size_t i = 0; i < primitives.size(); i++) {
+            build(i);
+        }
+
+        return map;
+    }
+}
+
+#endif // SC_HW_GRAPH_H
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_MARKOV_H
+#define SC_HW_MARKOV_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <systemc>
+
+// Continuous-time Markov chains solved by uniformization, and a memory
+// model in which single-bit errors accumulate in a codeword between two
+// patrol scrubs.
+
+namespace sc_hw_markov {
+
+    // Sparse CTMC with tagged transitions. Rates are per hour, the cost of
+    // a solution is O(rate * t * transitions).
+    class ctmc {
+
+    public:
+
+        struct transition
+        {
+            std::size_t from;
+            std::size_t to;
+            double rate;
+            int tag;
+        };
+
+        explicit ctmc(std::size_t states) : states(states) {}
+
+        void add(std::size_t from, std::size_t to, double rate, int tag = -1) {
+            sc_assert((from < states) && (to < states) && (from != to) && (rate >= 0.0));
+            transitions.push_back(transition{from, to, rate, tag});
+        }
+
+        std::size_t size() const {
+            return states;
+        }
+
+        // State distribution at time t
+        std::vector<double> transient(const std::vector<double>& p0, double t, double epsilon = 1e-12) const {
+            std::vector<double> p(states, 0.0);
+            uniformize(p0, t, epsilon, [&](const std::vector<double>& v, double weight, double) {
+                for (std::size_t i = 0; i < states; i++) {
+                    p[i] += weight * v[i];
+                }
+            });
+            return p;
+        }
+
+        // Expected time spent in every state during [0, t]
+        std::vector<double> occupancy(const std::vector<double>& p0, double t, double epsilon = 1e-12) const {
+            std::vector<double> o(states, 0.0);
+            double lambda = uniformization_rate();
+
+            if (lambda == 0.0) {
+                for (std::size_t i = 0; i < states; i++) {
+                    o[i] = p0[i] * t;
+                }
+                return o;
+            }
+
+            uniformize(p0, t, epsilon, [&](const std::vector<double>& v, double, double tail) {
+                for (std::size_t i = 0; i < states; i++) {
+                    o[i] += tail * v[i] / lambda;
+                }
+            });
+            return o;
+        }
+
+        // Expected number of transitions of every tag during [0, t]
+        std::vector<double> counts(const std::vector<double>& p0, double t, std::size_t tags, double epsilon = 1e-12) const {
+            std::vector<double> o = occupancy(p0, t, epsilon);
+            std::vector<double> c(tags, 0.0);
+
+            for (auto& e : transitions) {
+                if ((e.tag >= 0) && (std::size_t(e.tag) < tags)) {
+                    c[e.tag] += e.rate * o[e.from];
+                }
+            }
+            return c;
+        }
+
+        // Expected number of entries minus exits of every state during
+        // [0, t], i.e. p(t) - p0 that stays accurate for rare transitions
+        std::vector<double> net_flow(const std::vector<double>& p0, double t, double epsilon = 1e-12) const {
+            std::vector<double> o = occupancy(p0, t, epsilon);
+            std::vector<double> n(states, 0.0);
+
+            for (auto& e : transitions) {
+                n[e.to] += e.rate * o[e.from];
+                n[e.from] -= e.rate * o[e.from];
+            }
+            return n;
+        }
+
+    private:
+
+        std::size_t states;
+        std::vector<transition> transitions;
+
+        double uniformization_rate() const {
+            std::vector<double> exit(states, 0.0);
+            for (auto& e : transitions) {
+                exit[e.from] += e.rate;
+            }
+            return *std::max_element(exit.begin(), exit.end());
+        }
+
+        // Calls f(p0 * P^k, poisson(k), 1 - sum of poisson(0..k)) with
+        // P = I + Q / lambda until both the weight and the tail are below
+        // epsilon
+        template <class F>
+        void uniformize(const std::vector<double>& p0, double t, double epsilon, F f) const {
+            sc_assert((p0.size() == states) && (t >= 0.0));
+
+            double lambda = uniformization_rate();
+            double x = lambda * t;
+            std::vector<double> v = p0, next(states);
+
+            if (x == 0.0) {
+                f(v, 1.0, 0.0);
+                return;
+            }
+
+            double tail = -std::expm1(-x);
+            f(v, std::exp(-x), tail);
+
+            for (std::size_t k = 1; (k <= x) || (tail > epsilon); k++) {
+                next = v;
+                for (auto& e : transitions) {
+                    double flow = v[e.from] * e.rate / lambda;
+                    next[e.to] += flow;
+                    next[e.from] -= flow;
+                }
+                v.swap(next);
+
+                double weight = std::exp(-x + k * std::log(x) - std::lgamma(k + 1.0));
+                tail = std::max(tail - weight, 0.0);
+                f(v, weight, tail);
+            }
+        }
+    };
+
+    struct scrub_rates
+    {
+        double sbe;
+        double dbe;
+        double mbe;
+    };
+
+    // Effective SBE, DBE and MBE FIT of a memory in which raw single-bit,
+    // double-bit and multi-bit faults (FIT) hit codewords of word_bits bits
+    // that are scrubbed every scrub_interval hours. A single-bit fault in a
+    // word that still holds an uncorrected error turns it into a DBE or MBE.
+    // The scrub corrects or reports the word, so every interval starts from
+    // a clean word and a word counts once, with the error it has at the
+    // scrub: an SBE that escalates is only a DBE or MBE.
+    inline scrub_rates scrubbed_rates(double sbe_fit, double dbe_fit, double mbe_fit,
+                                      double scrub_interval, double memory_bits, unsigned word_bits = 136)
+    {
+        enum { clean, single, double_error, multi, states };
+
+        sc_assert((scrub_interval > 0.0) && (memory_bits >= word_bits) && (word_bits > 2));
+
+        double words = memory_bits / word_bits;
+        double s = sbe_fit * 1e-9 / words;
+        double d = dbe_fit * 1e-9 / words;
+        double m = mbe_fit * 1e-9 / words;
+        double n = word_bits;
+
+        ctmc c(states);
+        c.add(clean, single, s);
+        c.add(clean, double_error, d);
+        c.add(clean, multi, m);
+        c.add(single, double_error, s * (n - 1) / n);
+        c.add(single, multi, d + m);
+        c.add(double_error, multi, s * (n - 2) / n + d + m);
+
+        std::vector<double> p0(states, 0.0);
+        p0[clean] = 1.0;
+
+        std::vector<double> p = c.net_flow(p0, scrub_interval);
+        double scale = words * 1e9 / scrub_interval;
+
+        return scrub_rates{p[single] * scale, p[double_error] * scale, p[multi] * scale};
+    }
+
+    // Drop-in between the DRAM fault rates and the first ECC stage
+    SC_MODULE(scrubbed_memory)
+    {
+        sc_core::sc_in<double> sbe_rate;
+        sc_core::sc_in<double> dbe_rate;
+        sc_core::sc_in<double> mbe_rate;
+        sc_core::sc_in<double> wd_rate;
+        sc_core::sc_out<double> sbe;
+        sc_core::sc_out<double> dbe;
+        sc_core::sc_out<double> mbe;
+        sc_core::sc_out<double> wd;
+
+        double scrub_interval;
+        double memory_bits;
+        unsigned word_bits;
+
+        scrubbed_memory(const sc_core::sc_module_name& name, double scrub_interval, double memory_bits,
+                        unsigned word_bits = 136) : sbe_rate("sbe_rate"),
+                                                    dbe_rate("dbe_rate"),
+                                                    mbe_rate("mbe_rate"),
+                                                    wd_rate("wd_rate"),
+                                                    sbe("sbe"),
+                                                    dbe("dbe"),
+                                                    mbe("mbe"),
+                                                    wd("wd"),
+                                                    scrub_interval(scrub_interval),
+                                                    memory_bits(memory_bits),
+                                                    word_bits(word_bits)
+        {
+            SC_METHOD(compute);
+            sensitive << sbe_rate << dbe_rate << mbe_rate << wd_rate;
+        }
+
+        void compute() {
+            scrub_rates r = scrubbed_rates(sbe_rate.read(), dbe_rate.read(), mbe_rate.read(),
+                                           scrub_interval, memory_bits, word_bits);
+            sbe.write(r.sbe);
+            dbe.write(r.dbe);
+            mbe.write(r.mbe);
+            wd.write(wd_rate.read());
+        }
+    };
+}
+
+#endif // SC_HW_MARKOV_H
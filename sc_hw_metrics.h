@@ -33,12 +33,63 @@
  *    Matthias Jung
  */
 
+#ifndef SC_HW_METRICS_H
+#define SC_HW_METRICS_H
+
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <systemc>
 #include <numeric>
+#include <vector>
 
 namespace sc_hw_metrics {
 
+    static const char* const asil_levels[] = {"QM", "ASIL-A", "ASIL-B", "ASIL-C", "ASIL-D"};
+
+    // Index of a level name in asil_levels, -1 if there is none
+    inline int asil_index(const std::string& level)
+    {
+        for (int i = 0; i < 5; i++) {
+            if (level == asil_levels[i]) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Thresholds of a level: SPFM > spfm, LFM > lfm and residual < residual
+    // (ISO 26262-5). Every level implies the ones below.
+    struct asil_target
+    {
+        double spfm;
+        double lfm;
+        double residual;
+    };
+
+    static constexpr asil_target asil_targets[] = {
+        {-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()},
+        {-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 1000.0},
+        {90.0, 60.0, 100.0},
+        {97.0, 80.0, 100.0},
+        {99.0, 90.0, 10.0}
+    };
+
+    // Index into asil_levels for the given metrics
+    constexpr int asil_class(double spfm, double lfm, double residual)
+    {
+        int level = 4;
+
+        while (level > 0 && !(spfm > asil_targets[level].spfm &&
+                              lfm > asil_targets[level].lfm &&
+                              residual < asil_targets[level].residual)) {
+            level--;
+        }
+
+        return level;
+    }
+
     SC_MODULE(basic_event)
     {
         sc_core::sc_out<double> output;
@@ -55,6 +106,80 @@ namespace sc_hw_metrics {
         }
     };
 
+    // A failure rate that holds from start on until the next segment
+    struct rate_segment
+    {
+        sc_core::sc_time start;
+        double rate;
+    };
+
+    // basic_event whose rate is a piecewise constant function of simulated
+    // time, e.g. a bathtub curve or temperature phases of a mission profile.
+    // The rate is 0 before the first segment. The method only wakes up at
+    // breakpoints where the rate changes and the signal only notifies the
+    // downstream modules then, so a whole lifetime is a single sc_start()
+    // whose cost grows with the number of changes.
+    SC_MODULE(profile_event)
+    {
+        sc_core::sc_out<double> output;
+        std::vector<rate_segment> segments;
+
+        profile_event(const sc_core::sc_module_name& name, const std::vector<rate_segment>& profile) : output("output")
+        {
+            for (std::size_t i = 0; i < profile.size(); i++) {
+                const rate_segment& s = profile[i];
+                if (i > 0 && s.start <= profile[i - 1].start) {
+                    SC_REPORT_FATAL("PROFILE", "Segments must start at increasing times");
+                }
+                if (segments.empty() ? s.rate != 0.0 : s.rate != segments.back().rate) {
+                    segments.push_back(s);
+                }
+            }
+            SC_METHOD(compute_fit);
+        }
+
+        void compute_fit() {
+            sc_core::sc_time now = sc_core::sc_time_stamp();
+
+            while (next < segments.size() && segments[next].start <= now) {
+                next++;
+            }
+
+            output.write(next == 0 ? 0.0 : segments[next - 1].rate);
+
+            if (next < segments.size()) {
+                next_trigger(segments[next].start - now);
+            }
+        }
+
+    private:
+
+        std::size_t next = 0;
+    };
+
+    // count segments of equal length from 0 to end with the rate at their
+    // midpoints
+    inline std::vector<rate_segment> sample_rate(const std::function<double(const sc_core::sc_time&)>& rate,
+                                                 const sc_core::sc_time& end, std::size_t count)
+    {
+        std::vector<rate_segment> segments;
+        double length = end.to_seconds() / count;
+
+        for (std::size_t i = 0; i < count; i++) {
+            segments.push_back(rate_segment{sc_core::sc_time::from_seconds(i * length),
+                                            rate(sc_core::sc_time::from_seconds((i + 0.5) * length))});
+        }
+        return segments;
+    }
+
+    // Arrhenius acceleration of a failure rate at temperature from the rate
+    // at the reference temperature, activation energy in eV
+    inline double arrhenius(double activation_energy, double temperature, double reference)
+    {
+        const double boltzmann = 8.617333262e-5; // eV/K
+        return std::exp(activation_energy / boltzmann * (1.0 / (reference + 273.15) - 1.0 / (temperature + 273.15)));
+    }
+
     SC_MODULE(coverage)
     {
         sc_core::sc_in<double> input;
@@ -136,6 +261,39 @@ namespace sc_hw_metrics {
 
     };
 
+    // Sums with at least this many inputs are added pairwise
+    static const int wide_sum_threshold = 32;
+
+    // Pairwise sum: halves down to blocks of at most 256 values, which are
+    // added in eight independent lanes that the compiler can vectorize. The
+    // order only depends on count, so the result is deterministic, and the
+    // rounding error grows with log(count) instead of count.
+    inline std::size_t pairwise_half(std::size_t count)
+    {
+        return (count / 2 + 7) & ~std::size_t(7);
+    }
+
+    inline double pairwise_sum(const double* x, std::size_t count)
+    {
+        if (count > 256) {
+            std::size_t half = pairwise_half(count);
+            return pairwise_sum(x, half) + pairwise_sum(x + half, count - half);
+        }
+
+        double lanes[8] = {};
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            for (std::size_t j = 0; j < 8; j++) {
+                lanes[j] += x[i + j];
+            }
+        }
+        for (std::size_t j = 0; j < 8 && i + j < count; j++) {
+            lanes[j] += x[i + j];
+        }
+
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
     SC_MODULE(sum)
     {
         sc_core::sc_port<sc_core::sc_signal_in_if<double>, 0, sc_core::SC_ONE_OR_MORE_BOUND> inputs;
@@ -147,13 +305,45 @@ namespace sc_hw_metrics {
             sensitive << inputs;
         }
 
+        // The bindings and with them the addresses of the channel values do
+        // not change after elaboration
+        void end_of_elaboration() override {
+            values.clear();
+            if (inputs.size() >= wide_sum_threshold) {
+                for (int i = 0; i < inputs.size(); i++) {
+                    values.push_back(&inputs[i]->read());
+                }
+            }
+            buffer.resize(values.size());
+        }
+
+        // Narrow sums add in input order. Wide sums gather the current
+        // values of their channels into a contiguous buffer and add it
+        // pairwise.
         void compute_fit() {
-            double sum = 0.0;
-            for(int i=0; i < inputs.size(); i++) {
-                sum += inputs[i]->read();
+            if (inputs.size() < wide_sum_threshold) {
+                double sum = 0.0;
+                for(int i=0; i < inputs.size(); i++) {
+                    sum += inputs[i]->read();
+                }
+                output.write(sum);
+                return;
+            }
+
+            for (std::size_t i = 0; i < values.size(); i++) {
+                buffer[i] = *values[i];
             }
-            output.write(sum);
+            output.write(pairwise_sum(buffer.data(), buffer.size()));
         }
+
+        std::size_t heap_bytes() const {
+            return values.capacity() * sizeof(const double*) + buffer.capacity() * sizeof(double);
+        }
+
+    private:
+
+        std::vector<const double*> values;
+        std::vector<double> buffer;
     };
 
     SC_MODULE(pass) // TODO: Kann man das nicht durch ein signal lösen?
@@ -175,6 +365,8 @@ namespace sc_hw_metrics {
     {
         sc_core::sc_in<double> residual;
         sc_core::sc_in<double> latent;
+        // Optional, replaces the fixed total if the rates change over time
+        sc_core::sc_port<sc_core::sc_signal_in_if<double>, 1, sc_core::SC_ZERO_OR_MORE_BOUND> total_rate;
 
         double spfm{};
         double lfm{};
@@ -184,30 +376,18 @@ namespace sc_hw_metrics {
 
         asil(const sc_core::sc_module_name& name, double total) : total(total) {
             SC_METHOD(compute);
-            sensitive << residual << latent;
+            sensitive << residual << latent << total_rate;
         }
 
         void compute() {
-            spfm = 100 * (1 - (residual / (total)));
-            lfm = 100 * (1 - (latent / (total - residual)));
-
-            asil_level = "QM";
-
-            if(residual < 1000.0) {
-                asil_level = "ASIL-A";
-            }
-
-            if(spfm > 90.0 && lfm > 60.0 && residual < 100.0) {
-                asil_level = "ASIL-B";
+            if (total_rate.bind_count() != 0) {
+                total = total_rate->read();
             }
 
-            if(spfm > 97.0 && lfm > 80.0 && residual < 100.0) {
-                asil_level = "ASIL-C";
-            }
+            spfm = 100 * (1 - (residual / (total)));
+            lfm = 100 * (1 - (latent / (total - residual)));
 
-            if(spfm > 99.0 && lfm > 90.0 && residual < 10.0) {
-                asil_level = "ASIL-D";
-            }
+            asil_level = asil_levels[asil_class(spfm, lfm, residual)];
         }
 
         void end_of_simulation() override {
@@ -220,4 +400,115 @@ namespace sc_hw_metrics {
             std::cout << "Time:  " << sc_core::sc_time_stamp() << " Deltas:" << sc_core::sc_delta_count() << std::endl;
         }
     };
+
+    // Latent fault inputs of pmhf. Every binding carries the diagnostic test
+    // interval in hours after which its latent faults are detected, 0 if they
+    // are never detected during the vehicle lifetime.
+    class sc_latent_in : public sc_core::sc_port<sc_core::sc_signal_in_if<double>,0,sc_core::SC_ONE_OR_MORE_BOUND>
+    {
+    public:
+        std::vector<double> test_intervals;
+
+        void bind(sc_core::sc_signal_in_if<double>& interface, double test_interval)
+        {
+            sc_core::sc_port_base::bind(interface);
+            test_intervals.push_back(test_interval);
+        }
+
+        void bind(sc_core::sc_in<double>& parent, double test_interval)
+        {
+            sc_core::sc_port_base::bind(parent);
+            test_intervals.push_back(test_interval);
+        }
+    };
+
+    // Vehicle lifetime in hours and optionally one test interval per latent
+    // binding that replaces the bound one
+    struct pmhf_scenario
+    {
+        double lifetime;
+        std::vector<double> test_intervals;
+    };
+
+    // Probabilistic metric for random hardware failures (ISO 26262-5, 9.4.2)
+    // in the dual-point approximation: the residual rate plus, for every
+    // latent fault, the rate of a second fault of the element (total) within
+    // the mean exposure time, half the test interval or half the lifetime:
+    //
+    //   PMHF = residual + sum_i total * latent_i * T_i / 2 * 1e-9   [FIT]
+    //
+    // All scenarios are evaluated in one pass, the exposure times are stored
+    // per latent input so the inner loop runs over contiguous scenarios.
+    SC_MODULE(pmhf)
+    {
+        sc_core::sc_in<double> residual;
+        sc_latent_in latent;
+
+        double total;
+        std::vector<pmhf_scenario> scenarios;
+        std::vector<double> values;      // PMHF per scenario in FIT
+        std::vector<int> classes;        // highest ASIL whose target is met, index into asil_levels
+
+        pmhf(const sc_core::sc_module_name& name, double total, std::vector<pmhf_scenario> scenarios) : total(total),
+                                                                                                     scenarios(std::move(scenarios))
+        {
+            SC_METHOD(compute);
+            sensitive << residual << latent;
+        }
+
+        void end_of_elaboration() override {
+            std::size_t n = scenarios.size();
+            exposure.assign(latent.size() * n, 0.0);
+
+            for (std::size_t s = 0; s < n; s++) {
+                auto& scenario = scenarios[s];
+
+                if (!scenario.test_intervals.empty() && scenario.test_intervals.size() != latent.test_intervals.size()) {
+                    SC_REPORT_FATAL("PMHF", "Scenario needs one test interval per latent input");
+                }
+
+                for (std::size_t i = 0; i < latent.test_intervals.size(); i++) {
+                    double t = scenario.test_intervals.empty() ? latent.test_intervals[i] : scenario.test_intervals[i];
+                    exposure[i * n + s] = 0.5 * ((t > 0.0 && t < scenario.lifetime) ? t : scenario.lifetime);
+                }
+            }
+        }
+
+        void compute() {
+            std::size_t n = scenarios.size();
+            values.assign(n, residual.read());
+            classes.assign(n, 0);
+
+            for (int i = 0; i < latent.size(); i++) {
+                double k = 1e-9 * total * latent[i]->read();
+                const double* e = exposure.data() + i * n;
+                double* v = values.data();
+
+                for (std::size_t s = 0; s < n; s++) {
+                    v[s] += k * e[s];
+                }
+            }
+
+            for (std::size_t s = 0; s < n; s++) {
+                int level = 4;
+                while (level > 0 && !(values[s] < asil_targets[level].residual)) {
+                    level--;
+                }
+                classes[s] = level;
+            }
+        }
+
+        void end_of_simulation() override {
+            for (std::size_t s = 0; s < scenarios.size(); s++) {
+                std::cout << "PMHF:  " << values[s] << " FIT (" << asil_levels[classes[s]] << ") lifetime "
+                          << scenarios[s].lifetime << "h" << std::endl;
+            }
+        }
+
+    private:
+
+        std::vector<double> exposure; // latent input x scenario
+    };
 }
+
+#endif // SC_HW_METRICS_H
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_METRICS_INTERVAL_H
+#define SC_HW_METRICS_INTERVAL_H
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <systemc>
+
+#include "sc_hw_metrics.h"
+
+// Interval version of the sc_hw_metrics primitives: every rate, coverage and
+// split rate is a closed interval [lower, upper], so a single simulation
+// bounds the metrics over the whole box of uncertain parameters.
+
+namespace sc_hw_metrics_interval {
+
+    class interval {
+
+    public:
+
+        double lower;
+        double upper;
+
+        interval(double value = 0.0) : lower(value), upper(value) {}
+
+        interval(double lower, double upper) : lower(lower), upper(upper) {
+            sc_assert(lower <= upper);
+        }
+
+        double width() const {
+            return upper - lower;
+        }
+
+        bool contains(double d) const {
+            return (lower <= d) && (d <= upper);
+        }
+
+        static interval hull(const interval& a, const interval& b) {
+            return interval(std::min(a.lower, b.lower), std::max(a.upper, b.upper));
+        }
+
+        bool operator==(const interval& i) const {
+            return (this->lower == i.lower) && (this->upper == i.upper);
+        }
+
+        friend interval operator+(const interval& a, const interval& b) {
+            return interval(a.lower + b.lower, a.upper + b.upper);
+        }
+
+        friend interval operator-(const interval& a, const interval& b) {
+            return interval(a.lower - b.upper, a.upper - b.lower);
+        }
+
+        friend interval operator*(const interval& a, const interval& b) {
+            double p[] = {a.lower * b.lower, a.lower * b.upper, a.upper * b.lower, a.upper * b.upper};
+            return interval(*std::min_element(p, p + 4), *std::max_element(p, p + 4));
+        }
+
+        friend interval operator/(const interval& a, const interval& b) {
+            sc_assert((b.lower > 0.0) || (b.upper < 0.0));
+            return a * interval(1.0 / b.upper, 1.0 / b.lower);
+        }
+
+        inline friend void sc_trace(sc_core::sc_trace_file *tf, const interval & i, const std::string & name) {
+            sc_trace(tf, i.lower, name + ".lower");
+            sc_trace(tf, i.upper, name + ".upper");
+        }
+
+        inline friend std::ostream& operator << (std::ostream& os, interval const & i) {
+            return os << "[" << i.lower << ", " << i.upper << "]";
+        }
+    };
+
+    SC_MODULE(basic_event)
+    {
+        sc_core::sc_out<interval> output;
+        interval rate;
+
+        basic_event(const sc_core::sc_module_name& name, interval rate) : output("output"),
+                                                          rate(rate)
+        {
+            SC_METHOD(compute_fit);
+        }
+
+        void compute_fit() {
+            output.write(rate);
+        }
+    };
+
+    SC_MODULE(coverage)
+    {
+        sc_core::sc_in<interval> input;
+        sc_core::sc_out<interval> output;
+        sc_core::sc_port<sc_core::sc_signal_inout_if<interval>, 0, sc_core::SC_ZERO_OR_MORE_BOUND> latent;
+
+        interval dc;
+        interval lc;
+
+        coverage(const sc_core::sc_module_name& name, interval dc, interval lc) : input("input"),
+                                                       output("output"),
+                                                       dc(dc),
+                                                       lc(lc)
+        {
+            sc_assert((dc.lower >= 0.0) && (dc.upper <= 1.0));
+            sc_assert((lc.lower >= 0.0) && (lc.upper <= 1.0));
+            SC_METHOD(compute_fit);
+            sensitive << input;
+        }
+
+        // Both products are monotone: the bounds are reached at the corners
+        void compute_fit()
+        {
+            output.write(input.read() * (1.0 - dc));
+            if(latent.bind_count() != 0) {
+                latent->write(input.read() * (1.0 - lc));
+            }
+        }
+    };
+
+    class sc_split_out : public sc_core::sc_port<sc_core::sc_signal_inout_if<interval>,0,sc_core::SC_ONE_OR_MORE_BOUND>
+    {
+    public:
+        std::vector<interval> split_rates;
+
+        void bind(sc_core::sc_interface& interface , interval rate)
+        {
+            sc_core::sc_port_base::bind(interface);
+            split_rates.push_back(rate);
+        }
+
+        void bind(sc_core::sc_out<interval>& parent, interval rate)
+        {
+            sc_core::sc_port_base::bind(parent);
+            split_rates.push_back(rate);
+        }
+    };
+
+    SC_MODULE(split)
+    {
+        sc_core::sc_in<interval> input;
+        sc_split_out outputs;
+
+        split(const sc_core::sc_module_name& name) : sc_module(name), input("input")
+        {
+            SC_METHOD(compute_fit);
+            sensitive << input;
+        }
+
+        void compute_fit() {
+            for(int i=0; i < outputs.size(); i++) {
+                outputs[i]->write(input.read() * outputs.split_rates.at(i));
+            }
+        }
+
+        // Fatal if no point of the box is a valid split, warn if only some are
+        void before_end_of_elaboration() override {
+            interval total_rate = 0.0;
+
+            for (auto& n : outputs.split_rates) {
+                total_rate = total_rate + n;
+            }
+
+            if(total_rate.lower > 1.0)
+            {
+                std::cout << this->name() << " " << total_rate << " ";
+                SC_REPORT_FATAL("SPLIT", "Total Rate greater than 100%");
+            }
+
+            if(total_rate.upper > 1.0)
+            {
+                std::cout << this->name() << " " << total_rate << " ";
+                SC_REPORT_WARNING("SPLIT", "Total Rate may exceed 100%");
+            }
+        }
+    };
+
+    SC_MODULE(sum)
+    {
+        sc_core::sc_port<sc_core::sc_signal_in_if<interval>, 0, sc_core::SC_ONE_OR_MORE_BOUND> inputs;
+        sc_core::sc_out<interval> output;
+
+        sum(const sc_core::sc_module_name& name) : sc_core::sc_module(name), output("output")
+        {
+            SC_METHOD(compute_fit);
+            sensitive << inputs;
+        }
+
+        void compute_fit() {
+            interval sum = 0.0;
+            for(int i=0; i < inputs.size(); i++) {
+                sum = sum + inputs[i]->read();
+            }
+            output.write(sum);
+        }
+    };
+
+    SC_MODULE(pass)
+    {
+        sc_core::sc_in<interval> input;
+        sc_core::sc_out<interval> output;
+
+        pass(const sc_core::sc_module_name& name) : sc_core::sc_module(name) {
+            SC_METHOD(compute);
+            sensitive << input;
+        }
+
+        void compute() {
+            output.write(input.read());
+        }
+    };
+
+    // LFM over the box. Without a positive share of safe and detected faults
+    // there is no LFM, the bound is -inf then.
+    inline interval lfm_interval(const interval& residual, const interval& latent, const interval& total)
+    {
+        double lowest = -std::numeric_limits<double>::infinity();
+        double low = total.lower - residual.upper;
+        double high = total.upper - residual.lower;
+        return interval((low > 0.0) ? 100 * (1 - (latent.upper / low)) : lowest,
+                        (high > 0.0) ? 100 * (1 - (latent.lower / high)) : lowest);
+    }
+
+    SC_MODULE(asil)
+    {
+        sc_core::sc_in<interval> residual;
+        sc_core::sc_in<interval> latent;
+
+        interval spfm{};
+        interval lfm{};
+        std::string guaranteed_level;
+        std::string possible_level;
+
+        interval total;
+
+        asil(const sc_core::sc_module_name& name, interval total) : total(total) {
+            SC_METHOD(compute);
+            sensitive << residual << latent;
+        }
+
+        // SPFM falls with the residual and rises with the total, LFM falls
+        // with latent and residual. The ASIL classification is monotone in
+        // all three metrics, so the worst corner gives the level that holds
+        // for the whole box and the best corner the level that may be reached.
+        void compute() {
+            interval res = residual.read();
+            interval lat = latent.read();
+
+            spfm = interval(100 * (1 - (res.upper / total.lower)),
+                            100 * (1 - (res.lower / total.upper)));
+            lfm = lfm_interval(res, lat, total);
+
+            guaranteed_level = sc_hw_metrics::asil_levels[sc_hw_metrics::asil_class(spfm.lower, lfm.lower, res.upper)];
+            possible_level = sc_hw_metrics::asil_levels[sc_hw_metrics::asil_class(spfm.upper, lfm.upper, res.lower)];
+        }
+
+        void end_of_simulation() override {
+            std::cout << "RES:   " << residual   << std::endl;
+            std::cout << "LAT:   " << latent     << std::endl;
+            std::cout << "TOTAL: " << total      << std::endl;
+            std::cout << "SPFM:  " << spfm       << "%" << std::endl;
+            std::cout << "LFM:   " << lfm        << "%" << std::endl;
+            std::cout << "ASIL:  " << guaranteed_level << " (guaranteed), " << possible_level << " (possible)" << std::endl;
+            std::cout << "Time:  " << sc_core::sc_time_stamp() << " Deltas:" << sc_core::sc_delta_count() << std::endl;
+        }
+    };
+}
+
+#endif // SC_HW_METRICS_INTERVAL_H
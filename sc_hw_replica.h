@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_REPLICA_H
+#define SC_HW_REPLICA_H
+
+#include <string>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+
+// Replicated sub-models as one module, e.g. the DRAM chain of every channel
+// of a memory system. The structure is a compiled graph that all replicas
+// share together with its coefficients; the replicas only add their values
+// (sc_hw_graph::replicas). Ports exist for the boundary of the sub-model:
+// per replica one input for every basic event that is driven from outside,
+// per replica one output for every observed value, and one total over all
+// replicas for every observed value. Memory and evaluation time grow with
+// the size of the graph plus the number of replicas times its values,
+// instead of one module hierarchy per replica.
+
+namespace sc_hw_replica {
+
+    using output_port = sc_core::sc_port<sc_core::sc_signal_inout_if<double>, 1, sc_core::SC_ZERO_OR_MORE_BOUND>;
+
+    SC_MODULE(replicated)
+    {
+        sc_core::sc_vector<sc_core::sc_in<double>> inputs;   // input i of replica r at r * input count + i
+        sc_core::sc_vector<output_port> outputs;             // value k of replica r at r * value count + k, optional
+        sc_core::sc_vector<output_port> totals;              // value k summed over the replicas, optional
+
+        sc_hw_graph::replicas state;
+
+        replicated(const sc_core::sc_module_name& name, const sc_hw_graph::graph& structure,
+                   const std::vector<sc_hw_graph::node_id>& events, const std::vector<sc_hw_graph::value>& observed,
+                   std::size_t count) : inputs("inputs", count * events.size()),
+                                        outputs("outputs", count * observed.size()),
+                                        totals("totals", observed.size()),
+                                        state(structure, count),
+                                        events(events),
+                                        observed(observed)
+        {
+            for (auto n : events) {
+                if (structure.node_kind(n) != sc_hw_graph::kind::basic_event) {
+                    SC_REPORT_FATAL("REPLICA", ("Input " + structure.name(n) + " is not a basic event").c_str());
+                }
+            }
+
+            SC_METHOD(compute);
+            for (std::size_t i = 0; i < inputs.size(); i++) {
+                sensitive << inputs[i];
+            }
+        }
+
+        sc_core::sc_in<double>& input(std::size_t replica, std::size_t i) {
+            return inputs[replica * events.size() + i];
+        }
+
+        output_port& output(std::size_t replica, std::size_t k) {
+            return outputs[replica * observed.size() + k];
+        }
+
+        void compute() {
+            for (std::size_t r = 0; r < state.size(); r++) {
+                for (std::size_t i = 0; i < events.size(); i++) {
+                    state.set_rate(events[i], r, inputs[r * events.size() + i].read());
+                }
+            }
+
+            state.evaluate();
+
+            for (std::size_t k = 0; k < observed.size(); k++) {
+                for (std::size_t r = 0; r < state.size(); r++) {
+                    if (output(r, k).bind_count() != 0) {
+                        output(r, k)->write(state.read(observed[k], r));
+                    }
+                }
+                if (totals[k].bind_count() != 0) {
+                    totals[k]->write(state.total(observed[k]));
+                }
+            }
+        }
+
+        std::size_t heap_bytes() const {
+            return state.memory_bytes() + events.capacity() * sizeof(sc_hw_graph::node_id)
+                 + observed.capacity() * sizeof(sc_hw_graph::value);
+        }
+
+    private:
+
+        std::vector<sc_hw_graph::node_id> events;
+        std::vector<sc_hw_graph::value> observed;
+    };
+}
+
+#endif // SC_HW_REPLICA_H
@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_SERVER_H
+#define SC_HW_SERVER_H
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <systemc>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sc_hw_graph.h"
+#include "sc_hw_metrics.h"
+
+// Long-lived models that answer many small what-if questions without
+// paying process start and elaboration for each of them. The model is
+// built once, then every request line sets parameters and returns the
+// metrics:
+//
+//   request:   DRAM_FIT=2300 SEC[0]=0.99      (no assignments: current state)
+//   response:  ok SPFM LFM RESIDUAL LATENT ASIL
+//              error MESSAGE
+//
+// A request is applied completely or not at all: an unknown name, a value
+// outside of the range of its parameter or a result the model does not
+// allow, e.g. split rates above 100%, rejects all of it. "quit" ends the
+// server.
+// Requests come from stdin or from the clients of a UNIX socket, one client
+// after the other.
+//
+// graph_server serves an sc_hw_graph model, every coefficient k of a node
+// is a parameter NAME[k], coefficient 0 also NAME. Unnamed nodes are left
+// out, and names that several nodes share are rejected as ambiguous. model_server serves a
+// model of sc_hw_metrics modules: between two requests the simulation is
+// paused, the parameters are written into the modules and sc_start() runs
+// the delta cycles until the model has settled again.
+
+namespace sc_hw_server {
+
+    struct metrics
+    {
+        double spfm;
+        double lfm;
+        double residual;
+        double latent;
+        std::string asil;
+    };
+
+    struct request
+    {
+        std::vector<std::pair<std::string, double>> assignments;
+        bool quit = false;
+    };
+
+    // Returns false with the reason in error if the line is malformed
+    inline bool parse(const std::string& line, request& r, std::string& error)
+    {
+        std::istringstream tokens(line);
+        std::string token;
+
+        r = request();
+
+        while (tokens >> token) {
+            if (token == "quit") {
+                r.quit = true;
+                continue;
+            }
+
+            std::size_t equals = token.find('=');
+            if (equals == std::string::npos || equals == 0) {
+                error = "expected NAME=VALUE: " + token;
+                return false;
+            }
+
+            std::string text = token.substr(equals + 1);
+            char* end = nullptr;
+            double value = std::strtod(text.c_str(), &end);
+
+            if (text.empty() || *end != '\0') {
+                error = "not a number: " + token;
+                return false;
+            }
+
+            r.assignments.emplace_back(token.substr(0, equals), value);
+        }
+        return true;
+    }
+
+    inline std::string format(const metrics& m)
+    {
+        std::ostringstream os;
+        os.precision(std::numeric_limits<double>::max_digits10);
+        os << "ok " << m.spfm << " " << m.lfm << " " << m.residual << " " << m.latent << " " << m.asil;
+        return os.str();
+    }
+
+    class server {
+
+    public:
+
+        virtual ~server() = default;
+
+        // Values outside of [lower, upper] and not finite ones are rejected
+        void parameter(const std::string& name, std::function<void(double)> set,
+                       double lower = -std::numeric_limits<double>::infinity(),
+                       double upper = std::numeric_limits<double>::infinity()) {
+            if (!setters.emplace(name, setter{std::move(set), lower, upper}).second) {
+                SC_REPORT_ERROR("SERVER", ("Parameter " + name + " exists already").c_str());
+            }
+        }
+
+        // A name that several parameters would have, requests that use it
+        // are rejected
+        void ambiguous(const std::string& name) {
+            setters.erase(name);
+            ambiguous_names.insert(name);
+        }
+
+        bool has_parameter(const std::string& name) const {
+            return setters.count(name) != 0;
+        }
+
+        std::vector<std::string> parameters() const {
+            std::vector<std::string> names;
+            for (auto& s : setters) {
+                names.push_back(s.first);
+            }
+            return names;
+        }
+
+        // Answers one request line, quit is set if the server should stop
+        std::string handle(const std::string& line, bool& quit) {
+            request r;
+            std::string error;
+
+            quit = false;
+            if (!parse(line, r, error)) {
+                return "error " + error;
+            }
+
+            for (auto& a : r.assignments) {
+                if (ambiguous_names.count(a.first) != 0) {
+                    return "error ambiguous parameter " + a.first;
+                }
+                auto it = setters.find(a.first);
+                if (it == setters.end()) {
+                    return "error unknown parameter " + a.first;
+                }
+                if (!std::isfinite(a.second) || a.second < it->second.lower || a.second > it->second.upper) {
+                    std::ostringstream os;
+                    os << "error " << a.first << " out of range [" << it->second.lower << ", "
+                       << it->second.upper << "]";
+                    return os.str();
+                }
+            }
+
+            error = check(r);
+            if (!error.empty()) {
+                return "error " + error;
+            }
+
+            if (!started) {
+                start();
+                started = true;
+            }
+
+            for (auto& a : r.assignments) {
+                setters.at(a.first).set(a.second);
+            }
+
+            quit = r.quit;
+            served++;
+            return format(query());
+        }
+
+        // Serves the requests of one stream until quit or end of input,
+        // returns true on quit
+        bool serve(int in, int out) {
+            std::string buffer;
+            char chunk[4096];
+
+            while (true) {
+                std::size_t newline;
+
+                while ((newline = buffer.find('\n')) != std::string::npos) {
+                    bool quit;
+                    std::string response = handle(buffer.substr(0, newline), quit) + "\n";
+                    buffer.erase(0, newline + 1);
+
+                    if (!write_all(out, response) || quit) {
+                        return quit;
+                    }
+                }
+
+                ssize_t n = ::read(in, chunk, sizeof(chunk));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return false;
+                }
+                buffer.append(chunk, n);
+            }
+        }
+
+        void serve_stdio() {
+            serve(STDIN_FILENO, STDOUT_FILENO);
+        }
+
+        // Accepts clients on a UNIX socket until one of them sends quit. A
+        // stale socket at path is replaced, any other file is left alone.
+        void serve_socket(const std::string& path) {
+            sockaddr_un address{};
+            struct stat status;
+
+            if (path.size() >= sizeof(address.sun_path)) {
+                SC_REPORT_ERROR("SERVER", ("Socket path too long: " + path).c_str());
+                return;
+            }
+
+            if (::lstat(path.c_str(), &status) == 0) {
+                if (!S_ISSOCK(status.st_mode)) {
+                    SC_REPORT_ERROR("SERVER", (path + " exists and is not a socket").c_str());
+                    return;
+                }
+                ::unlink(path.c_str());
+            }
+
+            int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener < 0) {
+                SC_REPORT_ERROR("SERVER", (std::string("Cannot create socket: ") + std::strerror(errno)).c_str());
+                return;
+            }
+
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+            if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+                || ::listen(listener, 8) != 0) {
+                ::close(listener);
+                SC_REPORT_ERROR("SERVER", ("Cannot listen on " + path + ": " + std::strerror(errno)).c_str());
+                return;
+            }
+
+            bool quit = false;
+            while (!quit) {
+                int client = ::accept(listener, nullptr, nullptr);
+                if (client < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    SC_REPORT_ERROR("SERVER", std::strerror(errno));
+                    break;
+                }
+#if defined(SO_NOSIGPIPE)
+                int on = 1;
+                ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+                quit = serve(client, client);
+                ::close(client);
+            }
+
+            ::close(listener);
+            ::unlink(path.c_str());
+        }
+
+        std::size_t requests() const {
+            return served;
+        }
+
+    protected:
+
+        // Called once before the first parameter is set
+        virtual void start() {}
+
+        // Checks a request whose values are all in range as a whole, returns
+        // the reason to reject it or an empty string
+        virtual std::string check(const request&) {
+            return "";
+        }
+
+        virtual metrics query() = 0;
+
+    private:
+
+        struct setter
+        {
+            std::function<void(double)> set;
+            double lower;
+            double upper;
+        };
+
+        std::map<std::string, setter> setters;
+        std::set<std::string> ambiguous_names;
+        bool started = false;
+        std::size_t served = 0;
+
+        // A client that disconnects must not raise SIGPIPE in the server,
+        // send does not for sockets, write is only used for other files
+        static bool write_all(int fd, const std::string& s) {
+            std::size_t done = 0;
+#if defined(MSG_NOSIGNAL)
+            int flags = MSG_NOSIGNAL;
+#else
+            int flags = 0;
+#endif
+            bool socket = true;
+
+            while (done < s.size()) {
+                ssize_t n = socket ? ::send(fd, s.data() + done, s.size() - done, flags) : -1;
+                if (n < 0 && socket && errno == ENOTSOCK) {
+                    socket = false;
+                }
+                if (!socket) {
+                    n = ::write(fd, s.data() + done, s.size() - done);
+                }
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return false;
+                }
+                done += n;
+            }
+            return true;
+        }
+    };
+
+    // Serves an sc_hw_graph model with the metrics of one of its asil nodes
+    template <class T>
+    class basic_graph_server : public server {
+
+    public:
+
+        basic_graph_server(sc_hw_graph::basic_graph<T>& g, sc_hw_graph::node_id asil) : g(g), asil(asil)
+        {
+            sc_assert(g.compiled() && g.node_kind(asil) == sc_hw_graph::kind::asil);
+
+            // Unnamed nodes have no parameters, a name that several nodes
+            // share cannot be set
+            std::map<std::string, std::size_t> uses;
+            for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+                for (std::size_t k = 0; k < g.coefficient_count(n) && !g.name(n).empty(); k++) {
+                    if (k == 0) {
+                        uses[g.name(n)]++;
+                    }
+                    uses[g.name(n) + "[" + std::to_string(k) + "]"]++;
+                }
+            }
+
+            for (auto& u : uses) {
+                if (u.second > 1) {
+                    SC_REPORT_WARNING("SERVER", ("Parameter " + u.first + " is ambiguous").c_str());
+                    ambiguous(u.first);
+                }
+            }
+
+            // Rates are not negative, coverages and split rates are shares
+            for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+                double upper = (g.node_kind(n) == sc_hw_graph::kind::basic_event)
+                             ? std::numeric_limits<double>::infinity() : 1.0;
+                for (std::size_t k = 0; k < g.coefficient_count(n) && !g.name(n).empty(); k++) {
+                    if (k == 0) {
+                        add(g.name(n), n, k, upper, uses);
+                    }
+                    add(g.name(n) + "[" + std::to_string(k) + "]", n, k, upper, uses);
+                }
+            }
+        }
+
+    protected:
+
+        // The rates of a split may not add up to more than 1, as the builder
+        // checks for them
+        std::string check(const request& r) override {
+            std::map<std::pair<sc_hw_graph::node_id, std::size_t>, double> values;
+            std::set<sc_hw_graph::node_id> splits;
+            for (auto& a : r.assignments) {
+                auto& c = coefficients.at(a.first);
+                if (g.node_kind(c.first) == sc_hw_graph::kind::split) {
+                    values[c] = a.second;
+                    splits.insert(c.first);
+                }
+            }
+
+            for (sc_hw_graph::node_id n : splits) {
+                T total = T(0.0);
+                for (std::size_t k = 0; k < g.coefficient_count(n); k++) {
+                    auto it = values.find({n, k});
+                    total += (it != values.end()) ? T(it->second) : g.coefficient(n, k);
+                }
+                if (sc_hw_graph::lower(total) > 1.0) {
+                    return "rates of " + g.name(n) + " add up to more than 1";
+                }
+            }
+            return "";
+        }
+
+        metrics query() override {
+            g.evaluate();
+            return metrics{double(g.spfm(asil)), double(g.lfm(asil)), double(g.read(g.input(asil, 0))),
+                           double(g.read(g.input(asil, 1))), g.asil_level(asil)};
+        }
+
+    private:
+
+        sc_hw_graph::basic_graph<T>& g;
+        sc_hw_graph::node_id asil;
+        std::map<std::string, std::pair<sc_hw_graph::node_id, std::size_t>> coefficients;
+
+        void add(const std::string& name, sc_hw_graph::node_id n, std::size_t k, double upper,
+                 const std::map<std::string, std::size_t>& uses) {
+            if (uses.at(name) > 1) {
+                return;
+            }
+            coefficients[name] = {n, k};
+            parameter(name, [this, n, k](double c) { g.set_coefficient(n, k, c); }, 0.0, upper);
+        }
+    };
+
+    using graph_server = basic_graph_server<double>;
+
+    // Serves a model of sc_hw_metrics modules with the metrics of its asil
+    // module. Parameters are rates of basic events, NAME.dc and NAME.lc of
+    // coverages or any setter that changes the model from outside of a
+    // process. Must be created before the simulation starts.
+    class model_server : public server {
+
+    public:
+
+        model_server(const sc_hw_metrics::asil& a) : a(a) {}
+
+        using server::parameter;
+
+        void parameter(sc_hw_metrics::basic_event& e) {
+            parameter(e.name(), [&e](double rate) {
+                e.rate = rate;
+                e.compute_fit();
+            }, 0.0);
+        }
+
+        void parameter(sc_hw_metrics::coverage& c) {
+            parameter(std::string(c.name()) + ".dc", [&c](double dc) {
+                c.dc = dc;
+                c.compute_fit();
+            }, 0.0, 1.0);
+            parameter(std::string(c.name()) + ".lc", [&c](double lc) {
+                c.lc = lc;
+                c.compute_fit();
+            }, 0.0, 1.0);
+        }
+
+    protected:
+
+        void start() override {
+            sc_core::sc_start();
+        }
+
+        metrics query() override {
+            sc_core::sc_start();
+            return metrics{a.spfm, a.lfm, a.residual.read(), a.latent.read(), a.asil_level};
+        }
+
+    private:
+
+        const sc_hw_metrics::asil& a;
+    };
+}
+
+#endif // SC_HW_SERVER_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_SOLVE_H
+#define SC_HW_SOLVE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+#include "sc_hw_metrics.h"
+
+// Inverse problem on a graph: the smallest value of an unknown (a coverage,
+// a split rate, or several coefficients that move together) for which the
+// model reaches a target ASIL. Every threshold of the target (SPFM, LFM,
+// residual) is solved separately with the Illinois variant of regula falsi,
+// which needs few evaluations because the metrics are smooth rational
+// functions of a coefficient. The answer is the largest of the three roots.
+// The search moves from lower towards upper and assumes that the model stays
+// feasible once it is. For a split rate whose increase hurts, set lower above
+// upper to get the largest rate that is still feasible.
+
+namespace sc_hw_solve {
+
+    using sc_hw_graph::graph;
+    using sc_hw_graph::node_id;
+    using sc_hw_graph::parameter;
+
+    struct unknown
+    {
+        std::vector<parameter> parameters;
+        double lower = 0.0;
+        double upper = 1.0;
+    };
+
+    struct solution
+    {
+        bool feasible = false;
+        double value = 0.0;       // minimal feasible value, upper if infeasible
+        std::string limiting;     // constraint that determines value or infeasibility
+        std::size_t evaluations = 0;
+        double spfm = 0.0;        // metrics at value
+        double lfm = 0.0;
+        double residual = 0.0;
+    };
+
+    class solver {
+
+    public:
+
+        // g is solved in place, its coefficients are restored afterwards
+        solver(graph& g, const std::string& asil) : g(g)
+        {
+            g.compile();
+            this->asil = g.find(asil);
+            if (this->asil == g.size()) {
+                SC_REPORT_FATAL("SOLVE", ("No ASIL node " + asil).c_str());
+            }
+        }
+
+        // Value of u closest to u.lower, within tolerance, for which the
+        // model reaches target (an index into asil_levels)
+        solution solve(const unknown& u, int target, double tolerance = 1e-9) {
+            sc_assert(target >= 0 && target <= 4);
+
+            solution s;
+            nodes.clear();
+            original.clear();
+            evaluations = 0;
+
+            for (auto& p : u.parameters) {
+                node_id n = g.find(p.node);
+                if (n == g.size() || p.index >= g.coefficient_count(n)) {
+                    SC_REPORT_FATAL("SOLVE", ("No parameter " + p.node + "[" + std::to_string(p.index) + "]").c_str());
+                }
+                nodes.push_back(n);
+                original.push_back(g.coefficient(n, p.index));
+            }
+
+            thresholds = &sc_hw_metrics::asil_targets[target];
+            evaluated.clear();
+            evaluate(u, 0.0);
+            evaluate(u, 1.0);
+
+            // The search runs on t in [0, 1], value = lower + t * (upper - lower)
+            double width = std::abs(u.upper - u.lower);
+            double t_tolerance = (width > 0.0) ? tolerance / width : 1.0;
+            double t = 0.0;
+
+            s.feasible = true;
+
+            static const char* const names[] = {"SPFM", "LFM", "residual"};
+            for (int c = 0; c < 3; c++) {
+                double root;
+                if (!solve_constraint(u, c, t, t_tolerance, root)) {
+                    s.feasible = false;
+                    t = 1.0;
+                    s.limiting = names[c];
+                    break;
+                }
+                if (root > t) {
+                    t = root;
+                    s.limiting = names[c];
+                }
+            }
+
+            metrics m = evaluate(u, t);
+            s.value = value(u, t);
+            s.spfm = m.spfm;
+            s.lfm = m.lfm;
+            s.residual = m.residual;
+
+            if (s.feasible && sc_hw_metrics::asil_class(m.spfm, m.lfm, m.residual) < target) {
+                SC_REPORT_WARNING("SOLVE", "Metrics are not monotone in the unknown, no minimal value found");
+                s.feasible = false;
+            }
+
+            s.evaluations = evaluations;
+            restore(u);
+            return s;
+        }
+
+    private:
+
+        struct metrics
+        {
+            double spfm;
+            double lfm;
+            double residual;
+            double margin[3]; // > 0 if the constraint holds
+        };
+
+        graph& g;
+        node_id asil;
+        std::vector<node_id> nodes;
+        std::vector<double> original;
+        std::size_t evaluations = 0;
+        std::vector<std::pair<double, metrics>> evaluated;
+        const sc_hw_metrics::asil_target* thresholds = nullptr;
+
+        static double value(const unknown& u, double t) {
+            return (t == 1.0) ? u.upper : u.lower + t * (u.upper - u.lower);
+        }
+
+        // Returns earlier evaluations of the same point from the cache
+        metrics evaluate(const unknown& u, double t) {
+            for (auto& e : evaluated) {
+                if (e.first == t) {
+                    return e.second;
+                }
+            }
+
+            double x = value(u, t);
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                g.set_coefficient(nodes[i], u.parameters[i].index, x);
+            }
+            g.evaluate();
+            evaluations++;
+
+            metrics m;
+            m.residual = g.read(g.input(asil, 0));
+            m.spfm = g.spfm(asil);
+            m.lfm = g.lfm(asil);
+
+            // The LFM is undefined while the residual exceeds the total
+            bool defined = g.read(g.input(asil, 2)) > m.residual;
+            m.margin[0] = m.spfm - thresholds->spfm;
+            m.margin[1] = defined ? m.lfm - thresholds->lfm : -std::numeric_limits<double>::infinity();
+            m.margin[2] = thresholds->residual - m.residual;
+            evaluated.emplace_back(t, m);
+            return m;
+        }
+
+        void restore(const unknown& u) {
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                g.set_coefficient(nodes[i], u.parameters[i].index, original[i]);
+            }
+            g.evaluate();
+        }
+
+        // Illinois iteration on the margin of constraint c. a stays on the
+        // violated side and b on the satisfied side of the root. The initial
+        // bracket is the tightest one of all points evaluated so far, and the
+        // search stops once the root is known to be below current.
+        bool solve_constraint(const unknown& u, int c, double current, double tolerance, double& root) {
+            double a = 0.0, fa = 0.0;
+            double b = 1.0, fb = 0.0;
+            bool violated = false, satisfied = false;
+
+            for (auto& [x, m] : evaluated) {
+                if (m.margin[c] > 0.0) {
+                    if (!satisfied || x < b) {
+                        b = x;
+                        fb = m.margin[c];
+                        satisfied = true;
+                    }
+                } else if (!violated || x > a) {
+                    a = x;
+                    fa = m.margin[c];
+                    violated = true;
+                }
+            }
+
+            if (!satisfied) {
+                return false;
+            }
+
+            int side = 0;
+
+            while (violated && b > current && b - a > tolerance) {
+                double x;
+                if (std::isfinite(fa) && std::isfinite(fb)) {
+                    x = b - fb * (b - a) / (fb - fa);
+                } else {
+                    x = 0.5 * (a + b);
+                }
+
+                // Stay half a tolerance inside the bracket, so a step that
+                // hits the root closes the bracket with the next step
+                x = std::clamp(x, a + 0.5 * tolerance, b - 0.5 * tolerance);
+                if (!std::isfinite(x)) {
+                    x = 0.5 * (a + b);
+                }
+
+                double fx = evaluate(u, x).margin[c];
+
+                if (fx > 0.0) {
+                    b = x;
+                    fb = fx;
+                    if (side == 1) {
+                        fa /= 2;
+                    }
+                    side = 1;
+                } else {
+                    a = x;
+                    fa = fx;
+                    if (side == -1) {
+                        fb /= 2;
+                    }
+                    side = -1;
+                }
+            }
+
+            root = violated ? b : 0.0;
+            return true;
+        }
+    };
+}
+
+#endif // SC_HW_SOLVE_H
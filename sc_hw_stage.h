@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_STAGE_H
+#define SC_HW_STAGE_H
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <systemc>
+
+// Transfer stages over the DRAM error-class vector. A stage maps the FIT of
+// every error class at its input to the classes at its output with a dense
+// transfer matrix, and extracts residual and latent FIT with two vectors:
+//
+//   output   = transfer * input + source
+//   residual = residual . input + residual_source
+//   latent   = latent . input + latent_source
+//
+// Stages are closed under composition, so a chain of ECC stages is
+// multiplied out once and evaluating it for a new DRAM_FIT is one
+// matrix-vector product.
+
+namespace sc_hw_stage {
+
+    enum error_class : std::size_t { SBE, DBE, TBE, MBE, WD, AZ, error_classes };
+
+    static const char* error_class_names[] = {"SBE", "DBE", "TBE", "MBE", "WD", "AZ"};
+
+    using error_vector = std::array<double, error_classes>;
+
+    struct result
+    {
+        error_vector output;
+        double residual;
+        double latent;
+    };
+
+    class stage {
+
+    public:
+
+        std::string name;
+        std::array<error_vector, error_classes> transfer{}; // transfer[to][from]
+        error_vector source{};
+        error_vector residual{};
+        error_vector latent{};
+        double residual_source = 0.0;
+        double latent_source = 0.0;
+
+        stage(const std::string& name = "") : name(name) {}
+
+        // Every class leaves the stage unchanged
+        static stage identity(const std::string& name = "") {
+            stage s(name);
+            for (std::size_t c = 0; c < error_classes; c++) {
+                s.pass(error_class(c));
+            }
+            return s;
+        }
+
+        // Everything that reaches the end of a chain is residual
+        static stage sink(const std::string& name = "RESIDUAL") {
+            stage s(name);
+            for (std::size_t c = 0; c < error_classes; c++) {
+                s.exit(error_class(c));
+            }
+            return s;
+        }
+
+        // A share of class from becomes class to, behind an optional coverage
+        stage& route(error_class from, error_class to, double rate = 1.0, double dc = 0.0, double lc = 1.0) {
+            sc_assert((dc >= 0.0) && (dc <= 1.0) && (lc >= 0.0) && (lc <= 1.0));
+            share(from, rate);
+            transfer[to][from] += rate * (1 - dc);
+            latent[from] += rate * (1 - lc);
+            return *this;
+        }
+
+        stage& pass(error_class c) {
+            return route(c, c);
+        }
+
+        // A share of class from leaves the chain as residual
+        stage& exit(error_class from, double rate = 1.0) {
+            share(from, rate);
+            residual[from] += rate;
+            return *this;
+        }
+
+        // Basic event feeding class to, behind an optional coverage
+        stage& inject(error_class to, double fit, double dc = 0.0, double lc = 1.0) {
+            sc_assert((dc >= 0.0) && (dc <= 1.0) && (lc >= 0.0) && (lc <= 1.0));
+            source[to] += fit * (1 - dc);
+            latent_source += fit * (1 - lc);
+            return *this;
+        }
+
+        // Basic event that is latent by itself, e.g. a broken mechanism
+        stage& latent_event(double fit) {
+            latent_source += fit;
+            return *this;
+        }
+
+        result evaluate(const error_vector& input) const {
+            result r{source, residual_source, latent_source};
+
+            for (std::size_t from = 0; from < error_classes; from++) {
+                for (std::size_t to = 0; to < error_classes; to++) {
+                    r.output[to] += transfer[to][from] * input[from];
+                }
+                r.residual += residual[from] * input[from];
+                r.latent += latent[from] * input[from];
+            }
+
+            return r;
+        }
+
+        // This stage followed by next
+        stage then(const stage& next) const {
+            stage s(name + "." + next.name);
+            result r = next.evaluate(source);
+
+            s.source = r.output;
+            s.residual_source = residual_source + r.residual;
+            s.latent_source = latent_source + r.latent;
+
+            for (std::size_t from = 0; from < error_classes; from++) {
+                s.residual[from] = residual[from];
+                s.latent[from] = latent[from];
+
+                for (std::size_t via = 0; via < error_classes; via++) {
+                    for (std::size_t to = 0; to < error_classes; to++) {
+                        s.transfer[to][from] += next.transfer[to][via] * transfer[via][from];
+                    }
+                    s.residual[from] += next.residual[via] * transfer[via][from];
+                    s.latent[from] += next.latent[via] * transfer[via][from];
+                }
+            }
+
+            return s;
+        }
+
+        inline friend std::ostream& operator << (std::ostream& os, const stage& s) {
+            os << s.name << std::endl;
+            for (std::size_t to = 0; to < error_classes; to++) {
+                os << "  " << error_class_names[to] << ":";
+                for (std::size_t from = 0; from < error_classes; from++) {
+                    os << " " << s.transfer[to][from];
+                }
+                os << " + " << s.source[to] << std::endl;
+            }
+            os << "  RES:";
+            for (auto r : s.residual) {
+                os << " " << r;
+            }
+            os << " + " << s.residual_source << std::endl << "  LAT:";
+            for (auto l : s.latent) {
+                os << " " << l;
+            }
+            return os << " + " << s.latent_source << std::endl;
+        }
+
+    private:
+
+        error_vector shares{};
+
+        void share(error_class from, double rate) {
+            shares[from] += rate;
+            if (shares[from] > 1.0) {
+                std::cout << name << " " << error_class_names[from] << " " << shares[from] << " ";
+                SC_REPORT_FATAL("STAGE", "Total Rate greater than 100%");
+            }
+        }
+    };
+
+    inline stage chain(const std::vector<stage>& stages) {
+        sc_assert(!stages.empty());
+        stage s = stages.front();
+        for (std::size_t i = 1; i < stages.size(); i++) {
+            s = s.then(stages[i]);
+        }
+        return s;
+    }
+
+    // A stage, or a pre-composed chain of stages, as one module
+    SC_MODULE(transfer)
+    {
+        sc_core::sc_vector<sc_core::sc_in<double>> inputs;
+        sc_core::sc_vector<sc_core::sc_out<double>> outputs;
+        sc_core::sc_out<double> residual;
+        sc_core::sc_out<double> latent;
+
+        stage s;
+
+        transfer(const sc_core::sc_module_name& name, const stage& s) : inputs("inputs", error_classes),
+                                                                         outputs("outputs", error_classes),
+                                                                         residual("residual"),
+                                                                         latent("latent"),
+                                                                         s(s)
+        {
+            SC_METHOD(compute);
+            for (std::size_t c = 0; c < error_classes; c++) {
+                sensitive << inputs[c];
+            }
+        }
+
+        void compute() {
+            error_vector input;
+            for (std::size_t c = 0; c < error_classes; c++) {
+                input[c] = inputs[c].read();
+            }
+
+            result r = s.evaluate(input);
+
+            for (std::size_t c = 0; c < error_classes; c++) {
+                outputs[c].write(r.output[c]);
+            }
+            residual.write(r.residual);
+            latent.write(r.latent);
+        }
+    };
+}
+
+#endif // SC_HW_STAGE_H
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_STATIC_H
+#define SC_HW_STATIC_H
+
+#include <cstddef>
+#include <tuple>
+
+#include "sc_hw_metrics.h"
+
+// Compile-time form of the sc_hw_metrics primitives for models whose
+// constants are all fixed and that depend on a single runtime value, e.g.
+// DRAM_FIT. Every primitive is a type whose output is folded during
+// compilation into an affine function a * x + b of that input, so evaluating
+// a whole model is one multiply-add per result. Coverages outside [0, 1] and
+// splits whose rates add up to more than 100% do not compile.
+//
+//   using dram = split<input, 0.7, 0.3>;
+//   using res = coverage<output<dram, 0>, 0.99, 1.0>;
+//   res::value(2300.0);
+
+namespace sc_hw_static {
+
+    struct affine
+    {
+        double a;
+        double b;
+
+        constexpr double operator()(double x) const {
+            return a * x + b;
+        }
+
+        friend constexpr affine operator+(affine l, affine r) {
+            return affine{l.a + r.a, l.b + r.b};
+        }
+
+        friend constexpr affine operator*(affine l, double k) {
+            return affine{l.a * k, l.b * k};
+        }
+    };
+
+    // The runtime value the model depends on
+    struct input
+    {
+        static constexpr affine value{1.0, 0.0};
+    };
+
+    template <double Rate>
+    struct basic_event
+    {
+        static constexpr affine value{0.0, Rate};
+    };
+
+    template <class Input, double DC, double LC>
+    struct coverage
+    {
+        static_assert(DC >= 0.0 && DC <= 1.0, "Diagnostic coverage outside of [0, 1]");
+        static_assert(LC >= 0.0 && LC <= 1.0, "Latent coverage outside of [0, 1]");
+
+        static constexpr affine value = Input::value * (1 - DC);
+
+        struct latent_output
+        {
+            static constexpr affine value = Input::value * (1 - LC);
+        };
+    };
+
+    template <class Input, double... Rates>
+    struct split
+    {
+        static_assert(((Rates >= 0.0) && ...), "Negative split rate");
+        static_assert((Rates + ... + 0.0) <= 1.0, "Total Rate greater than 100%");
+
+        static constexpr double rates[] = {Rates...};
+
+        template <std::size_t I>
+        struct output
+        {
+            static_assert(I < sizeof...(Rates), "Split has no such output");
+            static constexpr affine value = Input::value * rates[I];
+        };
+    };
+
+    template <class... Inputs>
+    struct sum
+    {
+        static_assert(sizeof...(Inputs) > 0, "Sum without inputs");
+        static constexpr affine value = (Inputs::value + ...);
+    };
+
+    template <class Input>
+    using pass = sum<Input>;
+
+    // Output I of a split and the latent output of a coverage
+    template <class Split, std::size_t I>
+    using output = typename Split::template output<I>;
+
+    template <class Coverage>
+    using latent = typename Coverage::latent_output;
+
+    struct metrics
+    {
+        double residual;
+        double latent;
+        double total;
+        double spfm;
+        double lfm;
+        int asil_class;
+    };
+
+    template <class Residual, class Latent, class Total>
+    struct asil
+    {
+        static constexpr affine residual = Residual::value;
+        static constexpr affine latent = Latent::value;
+        static constexpr affine total = Total::value;
+
+        static constexpr metrics evaluate(double x) {
+            metrics m{residual(x), latent(x), total(x), 0.0, 0.0, 0};
+            m.spfm = 100 * (1 - (m.residual / m.total));
+            m.lfm = 100 * (1 - (m.latent / (m.total - m.residual)));
+            m.asil_class = sc_hw_metrics::asil_class(m.spfm, m.lfm, m.residual);
+            return m;
+        }
+    };
+}
+
+#endif // SC_HW_STATIC_H
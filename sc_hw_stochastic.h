@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_STOCHASTIC_H
+#define SC_HW_STOCHASTIC_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+#include "sc_parallel.h"
+
+// Monte Carlo check of the analytic FIT propagation of a compiled graph.
+// Faults arrive as a Poisson process at the rates of the basic events; the
+// simulation jumps from one arrival to the next and draws which event it
+// belongs to. Every fault is then routed through the graph: a split draws
+// one of its outputs (or none for the missing share), a coverage passes it
+// to its residual output with probability 1 - dc and to its latent output
+// with probability 1 - lc, and a value that feeds several nodes passes it to
+// all of them. The arrivals at the observed values over the simulated hours
+// are the empirical rates.
+//
+// Replicas are independent and run on the pool. Each one draws from its own
+// Philox stream, selected by seed and replica number, so results do not
+// depend on the number of threads or the order of the replicas. The
+// confidence intervals come from the spread of the replica rates.
+
+namespace sc_hw_stochastic {
+
+    // Counter-based generator Philox4x32-10 (Salmon et al., SC'11). One
+    // counter value gives four 32-bit words.
+    class philox {
+
+    public:
+
+        philox(std::uint64_t seed, std::uint64_t stream) : key{std::uint32_t(seed), std::uint32_t(seed >> 32)},
+                                                           counter{0, 0, std::uint32_t(stream), std::uint32_t(stream >> 32)}
+        {
+        }
+
+        // The block for a counter, e.g. for known answer tests
+        static void block(const std::uint32_t counter[4], const std::uint32_t key[2], std::uint32_t out[4]) {
+            std::uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+            std::uint32_t k[2] = {key[0], key[1]};
+
+            for (int round = 0; round < 10; round++) {
+                std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+                std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+                std::uint32_t next[4] = {std::uint32_t(p1 >> 32) ^ c[1] ^ k[0], std::uint32_t(p1),
+                                         std::uint32_t(p0 >> 32) ^ c[3] ^ k[1], std::uint32_t(p0)};
+                std::copy(next, next + 4, c);
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+
+            std::copy(c, c + 4, out);
+        }
+
+        std::uint32_t next() {
+            if (index == 4) {
+                block(counter, key, words);
+                if (++counter[0] == 0) {
+                    counter[1]++;
+                }
+                index = 0;
+            }
+            return words[index++];
+        }
+
+        // Uniform in (0, 1), never 0 so that its logarithm is finite
+        double uniform() {
+            // Two statements, the order of calls within one expression is unspecified
+            std::uint64_t high = next();
+            std::uint64_t low = next();
+            std::uint64_t bits = (high << 32 | low) >> 11;
+            return (bits + 0.5) * 0x1.0p-53;
+        }
+
+    private:
+
+        std::uint32_t key[2];
+        std::uint32_t counter[4];
+        std::uint32_t words[4] = {};
+        int index = 4;
+    };
+
+    struct options
+    {
+        double hours = 1e12;    // simulated hours per replica
+        std::size_t replicas = 64;
+        std::uint64_t seed = 1;
+        double z = 1.96;        // two-sided 95% confidence
+    };
+
+    // Empirical rate of one observed value in FIT with its confidence
+    // interval and the analytic rate of the graph
+    struct estimate
+    {
+        double rate;
+        double lower;
+        double upper;
+        double analytic;
+        std::uint64_t arrivals;
+
+        bool covers_analytic() const {
+            return lower <= analytic && analytic <= upper;
+        }
+
+        inline friend std::ostream& operator << (std::ostream& os, const estimate& e) {
+            return os << e.rate << " [" << e.lower << ", " << e.upper << "] analytic " << e.analytic
+                      << " (" << e.arrivals << " arrivals)";
+        }
+    };
+
+    // Only arrivals that reach at least one observed value can change a
+    // count, and the routing draws of one arrival are independent of all
+    // others. The simulator therefore precomputes for every value the
+    // probability reach[v] that a fault there is observed, thins each basic
+    // event to the arrivals that will be observed and routes these
+    // conditioned on being observed. Faults that are covered anyway, e.g. a
+    // large interface rate behind a strong link ECC, cost nothing, and the
+    // counts still have exactly the distribution of the plain routing.
+    class simulator {
+
+    public:
+
+        simulator(const sc_hw_graph::graph& g, const std::vector<sc_hw_graph::value>& observed) : g(g),
+                                                                                                  observed(observed),
+                                                                                                  consumers(g.values() + 1, 0),
+                                                                                                  slot(g.values(), -1),
+                                                                                                  reach(g.values(), 0.0),
+                                                                                                  node_reach(g.size(), 0.0)
+        {
+            sc_assert(g.compiled());
+
+            for (std::size_t i = 0; i < observed.size(); i++) {
+                slot[observed[i].id] = i;
+            }
+
+            // Consumer lists of every value in CSR form
+            for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+                for (std::size_t i = 0; i < g.input_count(n); i++) {
+                    consumers[g.input(n, i).id + 1]++;
+                }
+            }
+            for (std::size_t v = 0; v < g.values(); v++) {
+                consumers[v + 1] += consumers[v];
+            }
+            consumer_nodes.resize(consumers.back());
+            std::vector<std::uint32_t> fill(consumers.begin(), consumers.end() - 1);
+            for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+                for (std::size_t i = 0; i < g.input_count(n); i++) {
+                    consumer_nodes[fill[g.input(n, i).id]++] = n;
+                }
+            }
+
+            // Consumers come later in topological order than their inputs
+            for (sc_hw_graph::node_id n = g.size(); n-- > 0;) {
+                for (std::size_t k = 0; k < g.output_count(n); k++) {
+                    std::uint32_t v = g.output(n, k).id;
+                    double missed = 1.0;
+                    for (std::uint32_t i = consumers[v]; i < consumers[v + 1]; i++) {
+                        missed *= 1.0 - node_reach[consumer_nodes[i]];
+                    }
+                    reach[v] = (slot[v] >= 0) ? 1.0 : 1.0 - missed;
+                }
+                node_reach[n] = node_probability(n);
+            }
+
+            for (sc_hw_graph::node_id n = 0; n < g.size(); n++) {
+                if (g.node_kind(n) == sc_hw_graph::kind::basic_event) {
+                    double rate = g.coefficient(n, 0) * reach[g.output(n).id];
+                    if (rate > 0.0) {
+                        total_rate += rate;
+                        sources.push_back(n);
+                        cumulative.push_back(total_rate);
+                    }
+                }
+            }
+        }
+
+        // Rate in FIT of the arrivals that are observed at all
+        double observed_rate() const {
+            return total_rate;
+        }
+
+        std::vector<estimate> run(const options& o, sc_parallel::thread_pool& pool) const
+        {
+            sc_assert(o.hours > 0.0 && o.replicas > 0);
+
+            std::vector<std::vector<std::uint64_t>> counts(o.replicas, std::vector<std::uint64_t>(observed.size(), 0));
+
+            pool.parallel_for(o.replicas, [&](std::size_t r) {
+                replica(philox(o.seed, r), o.hours, counts[r]);
+            });
+
+            sc_hw_graph::instance analytic(g);
+            analytic.evaluate();
+
+            std::vector<estimate> result;
+            for (std::size_t i = 0; i < observed.size(); i++) {
+                double sum = 0.0, squares = 0.0;
+                std::uint64_t arrivals = 0;
+
+                for (auto& c : counts) {
+                    double rate = c[i] / o.hours * 1e9;
+                    sum += rate;
+                    squares += rate * rate;
+                    arrivals += c[i];
+                }
+
+                double mean = sum / o.replicas;
+                double error;
+                if (o.replicas > 1) {
+                    double variance = std::max(0.0, (squares - o.replicas * mean * mean) / (o.replicas - 1));
+                    error = std::sqrt(variance / o.replicas);
+                } else {
+                    // A single replica: Poisson error of the count
+                    error = std::sqrt(double(arrivals)) / o.hours * 1e9;
+                }
+
+                result.push_back(estimate{mean, std::max(0.0, mean - o.z * error), mean + o.z * error,
+                                          analytic.read(observed[i]), arrivals});
+            }
+            return result;
+        }
+
+    private:
+
+        const sc_hw_graph::graph& g;
+        std::vector<sc_hw_graph::value> observed;
+        std::vector<std::uint32_t> consumers;
+        std::vector<sc_hw_graph::node_id> consumer_nodes;
+        std::vector<std::int32_t> slot;
+        std::vector<double> reach;      // per value
+        std::vector<double> node_reach; // per node, for a fault at one of its inputs
+        std::vector<sc_hw_graph::node_id> sources;
+        std::vector<double> cumulative;
+        double total_rate = 0.0;
+
+        // Probability that node n passes a fault on to an observed value.
+        // The two coverage outputs are drawn independently.
+        double node_probability(sc_hw_graph::node_id n) const {
+            switch (g.node_kind(n)) {
+                case sc_hw_graph::kind::coverage: {
+                    double a = (1.0 - g.coefficient(n, 0)) * reach[g.output(n, 0).id];
+                    double b = (1.0 - g.coefficient(n, 1)) * reach[g.output(n, 1).id];
+                    return 1.0 - (1.0 - a) * (1.0 - b);
+                }
+                case sc_hw_graph::kind::split: {
+                    double p = 0.0;
+                    for (std::size_t i = 0; i < g.output_count(n); i++) {
+                        p += g.coefficient(n, i) * reach[g.output(n, i).id];
+                    }
+                    return p;
+                }
+                case sc_hw_graph::kind::sum:
+                    return reach[g.output(n).id];
+                default:
+                    return 0.0;
+            }
+        }
+
+        void replica(philox random, double hours, std::vector<std::uint64_t>& counts) const
+        {
+            if (sources.empty()) {
+                return;
+            }
+
+            double per_hour = total_rate * 1e-9;
+            std::vector<std::uint32_t> pending;
+
+            for (double t = -std::log(random.uniform()) / per_hour; t < hours; t -= std::log(random.uniform()) / per_hour) {
+                double u = random.uniform() * total_rate;
+                std::size_t source = std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+                pending.push_back(g.output(sources[std::min(source, sources.size() - 1)]).id);
+
+                while (!pending.empty()) {
+                    std::uint32_t v = pending.back();
+                    pending.pop_back();
+                    visit(v, random, counts, pending);
+                }
+            }
+        }
+
+        // A fault at value v that is known to be observed. Consumers that
+        // do not observe it are skipped. Until one of them has, each is
+        // drawn conditioned on one of the remaining ones observing it.
+        void visit(std::uint32_t v, philox& random, std::vector<std::uint64_t>& counts,
+                   std::vector<std::uint32_t>& pending) const
+        {
+            bool observed_already = (slot[v] >= 0);
+            if (observed_already) {
+                counts[slot[v]]++;
+            }
+
+            for (std::uint32_t i = consumers[v]; i < consumers[v + 1]; i++) {
+                double p = node_reach[consumer_nodes[i]];
+
+                if (!observed_already) {
+                    double missed = 1.0;
+                    for (std::uint32_t j = i; j < consumers[v + 1]; j++) {
+                        missed *= 1.0 - node_reach[consumer_nodes[j]];
+                    }
+                    p = (missed < 1.0) ? p / (1.0 - missed) : 0.0;
+                }
+
+                if (p > 0.0 && random.uniform() < p) {
+                    route(consumer_nodes[i], random, pending);
+                    observed_already = true;
+                }
+            }
+        }
+
+        // Node n passes on a fault that is known to be observed
+        void route(sc_hw_graph::node_id n, philox& random, std::vector<std::uint32_t>& pending) const {
+            switch (g.node_kind(n)) {
+                case sc_hw_graph::kind::coverage: {
+                    std::uint32_t output = g.output(n, 0).id, latent = g.output(n, 1).id;
+                    double a = (1.0 - g.coefficient(n, 0)) * reach[output];
+                    double b = (1.0 - g.coefficient(n, 1)) * reach[latent];
+
+                    if (random.uniform() * node_reach[n] < a) {
+                        pending.push_back(output);
+                        if (random.uniform() < b) {
+                            pending.push_back(latent);
+                        }
+                    } else {
+                        pending.push_back(latent);
+                    }
+                    break;
+                }
+                case sc_hw_graph::kind::split: {
+                    double u = random.uniform() * node_reach[n];
+                    std::size_t count = g.output_count(n);
+                    for (std::size_t i = 0; i < count; i++) {
+                        u -= g.coefficient(n, i) * reach[g.output(n, i).id];
+                        if (u < 0.0 || i + 1 == count) {
+                            pending.push_back(g.output(n, i).id);
+                            break;
+                        }
+                    }
+                    break;
+                }
+                case sc_hw_graph::kind::sum:
+                    pending.push_back(g.output(n).id);
+                    break;
+                default:
+                    break;
+            }
+        }
+    };
+
+    inline std::vector<estimate> simulate(const sc_hw_graph::graph& g, const std::vector<sc_hw_graph::value>& observed,
+                                          const options& o, sc_parallel::thread_pool& pool)
+    {
+        return simulator(g, observed).run(o, pool);
+    }
+}
+
+#endif // SC_HW_STOCHASTIC_H
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_HW_SWEEP_H
+#define SC_HW_SWEEP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <systemc>
+
+#include "sc_hw_graph.h"
+#include "sc_hw_metrics.h"
+
+// Adaptive sweeps that find where the ASIL classification of a model
+// changes over one or two parameters. A coarse grid is evaluated first,
+// then only the intervals (1-D, by bisection) or cells (2-D, as a quadtree)
+// whose ends or corners differ in their class are refined until they are
+// not larger than the tolerance. The tolerance is a fraction of the axis,
+// of its decades on a logarithmic axis. A class change that starts and
+// ends between two samples of the coarse grid is not found.
+
+namespace sc_hw_sweep {
+
+    struct axis
+    {
+        double lower;
+        double upper;
+        std::size_t points = 20; // of the coarse grid
+        bool logarithmic = false;
+
+        // Parameter value at the fraction t of the axis, the bounds of a
+        // logarithmic one are positive
+        double at(double t) const {
+            return logarithmic ? lower * std::pow(upper / lower, t) : lower + (upper - lower) * t;
+        }
+    };
+
+    struct sample
+    {
+        double x;
+        double y;  // 0 for 1-D sweeps
+        int asil;  // index into asil_levels
+    };
+
+    // The class changes between lower and upper
+    struct crossing
+    {
+        double lower;
+        double upper;
+        int lower_asil;
+        int upper_asil;
+    };
+
+    // A cell of the finest size with corners of different classes
+    struct cell
+    {
+        double x0, y0;
+        double x1, y1;
+        int lowest;
+        int highest;
+    };
+
+    struct result
+    {
+        std::vector<sample> samples; // every evaluated point, ordered by y and x
+        std::vector<crossing> crossings; // 1-D
+        std::vector<cell> boundary;      // 2-D
+
+        std::size_t evaluations() const {
+            return samples.size();
+        }
+    };
+
+    // Number of halvings until a coarse interval is not larger than the
+    // tolerance
+    inline int depth(const axis& a, double tolerance)
+    {
+        sc_assert(a.points >= 2 && tolerance > 0.0);
+        sc_assert(!a.logarithmic || (a.lower > 0.0 && a.upper > 0.0));
+        double width = 1.0 / (a.points - 1);
+        int d = 0;
+
+        while (width > tolerance && d < 30) {
+            width /= 2;
+            d++;
+        }
+        return d;
+    }
+
+    // Samples needed by a uniform grid with the resolution of the sweep
+    inline std::size_t dense_points(const axis& a, double tolerance)
+    {
+        return (a.points - 1) * (std::size_t(1) << depth(a, tolerance)) + 1;
+    }
+
+    inline std::size_t dense_points(const axis& x, const axis& y, double tolerance)
+    {
+        std::size_t size = std::size_t(1) << std::max(depth(x, tolerance), depth(y, tolerance));
+        return ((x.points - 1) * size + 1) * ((y.points - 1) * size + 1);
+    }
+
+    inline result sweep(const std::function<int(double)>& classify, const axis& x, double tolerance)
+    {
+        result r;
+        int d = depth(x, tolerance);
+        std::int64_t size = std::int64_t(1) << d;
+        std::int64_t end = (x.points - 1) * size;
+
+        auto evaluate = [&](std::int64_t i) {
+            int c = classify(x.at(double(i) / end));
+            r.samples.push_back(sample{x.at(double(i) / end), 0.0, c});
+            return c;
+        };
+
+        // Both halves of an interval with different classes at its ends
+        std::function<void(std::int64_t, int, std::int64_t, int)> refine;
+        refine = [&](std::int64_t i0, int c0, std::int64_t i1, int c1) {
+            if (c0 == c1) {
+                return;
+            }
+            if (i1 - i0 == 1) {
+                r.crossings.push_back(crossing{x.at(double(i0) / end), x.at(double(i1) / end), c0, c1});
+                return;
+            }
+            std::int64_t m = (i0 + i1) / 2;
+            int c = evaluate(m);
+            refine(i0, c0, m, c);
+            refine(m, c, i1, c1);
+        };
+
+        std::vector<int> coarse;
+        for (std::size_t p = 0; p < x.points; p++) {
+            coarse.push_back(evaluate(p * size));
+        }
+        for (std::size_t p = 0; p + 1 < x.points; p++) {
+            refine(p * size, coarse[p], (p + 1) * size, coarse[p + 1]);
+        }
+
+        std::sort(r.samples.begin(), r.samples.end(), [](const sample& a, const sample& b) { return a.x < b.x; });
+        return r;
+    }
+
+    inline result sweep(const std::function<int(double, double)>& classify, const axis& x, const axis& y,
+                        double tolerance)
+    {
+        result r;
+        int d = std::max(depth(x, tolerance), depth(y, tolerance));
+        std::int64_t size = std::int64_t(1) << d;
+        std::int64_t x_end = (x.points - 1) * size;
+        std::int64_t y_end = (y.points - 1) * size;
+        std::unordered_map<std::uint64_t, int> classes;
+
+        auto evaluate = [&](std::int64_t i, std::int64_t j) {
+            std::uint64_t key = (std::uint64_t(j) << 32) | std::uint64_t(i);
+            auto it = classes.find(key);
+            if (it != classes.end()) {
+                return it->second;
+            }
+            double px = x.at(double(i) / x_end), py = y.at(double(j) / y_end);
+            int c = classify(px, py);
+            classes.emplace(key, c);
+            r.samples.push_back(sample{px, py, c});
+            return c;
+        };
+
+        std::function<void(std::int64_t, std::int64_t, std::int64_t)> refine;
+        refine = [&](std::int64_t i, std::int64_t j, std::int64_t s) {
+            int corners[4] = {evaluate(i, j), evaluate(i + s, j), evaluate(i, j + s), evaluate(i + s, j + s)};
+            int lowest = *std::min_element(corners, corners + 4);
+            int highest = *std::max_element(corners, corners + 4);
+
+            if (lowest == highest) {
+                return;
+            }
+            if (s == 1) {
+                r.boundary.push_back(cell{x.at(double(i) / x_end), y.at(double(j) / y_end),
+                                          x.at(double(i + 1) / x_end), y.at(double(j + 1) / y_end), lowest, highest});
+                return;
+            }
+            s /= 2;
+            refine(i, j, s);
+            refine(i + s, j, s);
+            refine(i, j + s, s);
+            refine(i + s, j + s, s);
+        };
+
+        for (std::size_t q = 0; q + 1 < y.points; q++) {
+            for (std::size_t p = 0; p + 1 < x.points; p++) {
+                refine(p * size, q * size, size);
+            }
+        }
+
+        std::sort(r.samples.begin(), r.samples.end(), [](const sample& a, const sample& b) {
+            return (a.y < b.y) || (a.y == b.y && a.x < b.x);
+        });
+        return r;
+    }
+
+    template <class T>
+    sc_hw_graph::node_id find_parameter(const sc_hw_graph::basic_graph<T>& g, const sc_hw_graph::parameter& p)
+    {
+        sc_hw_graph::node_id n = g.find(p.node);
+        if (n == g.size() || p.index >= g.coefficient_count(n)) {
+            SC_REPORT_FATAL("SWEEP", ("Unknown parameter " + p.node + "[" + std::to_string(p.index) + "]").c_str());
+        }
+        return n;
+    }
+
+    // Keeps the original coefficients of the swept parameters and restores
+    // them, and the values of the graph, when the last copy of a classifier
+    // is destroyed
+    template <class T>
+    class restore
+    {
+    public:
+        explicit restore(sc_hw_graph::basic_graph<T>& g) : g(g) {}
+        restore(const restore&) = delete;
+        restore& operator=(const restore&) = delete;
+
+        void keep(sc_hw_graph::node_id n, std::size_t k) {
+            saved.push_back({n, k, g.coefficient(n, k)});
+        }
+
+        ~restore() {
+            for (auto it = saved.rbegin(); it != saved.rend(); ++it) {
+                g.set_coefficient(it->n, it->k, it->value);
+            }
+            try {
+                g.evaluate();
+            } catch (const sc_core::sc_report& report) {
+                SC_REPORT_WARNING("SWEEP", report.what());
+            }
+        }
+
+    private:
+        struct coefficient
+        {
+            sc_hw_graph::node_id n;
+            std::size_t k;
+            T value;
+        };
+
+        sc_hw_graph::basic_graph<T>& g;
+        std::vector<coefficient> saved;
+    };
+
+    // Sets the parameter of a compiled graph, evaluates it and returns the
+    // class of its asil node. The graph gets its original coefficients back
+    // once the classifier (and every copy of it) is gone, so it must not be
+    // read in between: sweep(classifier(g, ...), ...) leaves g as it was.
+    template <class T>
+    std::function<int(double)> classifier(sc_hw_graph::basic_graph<T>& g, sc_hw_graph::node_id asil,
+                                          const sc_hw_graph::parameter& p)
+    {
+        sc_hw_graph::node_id n = find_parameter(g, p);
+        auto saved = std::make_shared<restore<T>>(g);
+        saved->keep(n, p.index);
+        return [&g, asil, n, p, saved](double v) {
+            g.set_coefficient(n, p.index, v);
+            g.evaluate();
+            return g.asil_class(asil);
+        };
+    }
+
+    template <class T>
+    std::function<int(double, double)> classifier(sc_hw_graph::basic_graph<T>& g, sc_hw_graph::node_id asil,
+                                                  const sc_hw_graph::parameter& px, const sc_hw_graph::parameter& py)
+    {
+        sc_hw_graph::node_id nx = find_parameter(g, px), ny = find_parameter(g, py);
+        auto saved = std::make_shared<restore<T>>(g);
+        saved->keep(nx, px.index);
+        saved->keep(ny, py.index);
+        return [&g, asil, nx, ny, px, py, saved](double x, double y) {
+            g.set_coefficient(nx, px.index, x);
+            g.set_coefficient(ny, py.index, y);
+            g.evaluate();
+            return g.asil_class(asil);
+        };
+    }
+}
+
+#endif // SC_HW_SWEEP_H
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_MEMORY_REPORT_H
+#define SC_MEMORY_REPORT_H
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include <systemc>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+#include "sc_fta.h"
+#include "sc_hw_metrics.h"
+
+namespace sc_memory_report {
+
+    inline std::string demangle(const char* name)
+    {
+#if defined(__GNUG__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+            std::string result(demangled);
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    struct entry
+    {
+        std::string name;
+        std::string type;
+        std::string kind;
+        int depth;
+        bool registered;
+        std::size_t self_bytes;    // sizeof the object minus its member objects
+        std::size_t heap_bytes;    // names, port bindings, split rates, ...
+        std::size_t subtree_bytes; // self and heap bytes of the whole subtree
+    };
+
+    // Walks the object hierarchy after elaboration and attributes bytes to
+    // every object, its type and its subtree. The sizes of the sc_hw_metrics
+    // and sc_fta primitives and their channels are known, other types can be
+    // added with register_type. Objects of unknown types count with their
+    // heap bytes only. Memory owned by the SystemC kernel itself (processes,
+    // events, scheduler queues) is not included.
+    SC_MODULE(memory_report)
+    {
+        std::vector<entry> entries;
+
+        memory_report(const sc_core::sc_module_name& name, const std::string& csv_path = "") : csv_path(csv_path)
+        {
+            register_type<sc_hw_metrics::basic_event>();
+            register_type<sc_hw_metrics::profile_event>([](const sc_core::sc_object& object) {
+                return static_cast<const sc_hw_metrics::profile_event&>(object).segments.capacity() * sizeof(sc_hw_metrics::rate_segment);
+            });
+            register_type<sc_hw_metrics::coverage>();
+            register_type<sc_hw_metrics::split>();
+            register_type<sc_hw_metrics::sum>([](const sc_core::sc_object& object) {
+                return static_cast<const sc_hw_metrics::sum&>(object).heap_bytes();
+            });
+            register_type<sc_hw_metrics::pass>();
+            register_type<sc_hw_metrics::asil>([](const sc_core::sc_object& object) {
+                return string_bytes(static_cast<const sc_hw_metrics::asil&>(object).asil_level);
+            });
+
+            register_type<sc_hw_metrics::pmhf>([](const sc_core::sc_object& object) {
+                auto& p = static_cast<const sc_hw_metrics::pmhf&>(object);
+                std::size_t bytes = p.scenarios.capacity() * sizeof(sc_hw_metrics::pmhf_scenario)
+                                  + (p.values.capacity() + p.scenarios.size() * p.latent.size()) * sizeof(double)
+                                  + p.classes.capacity() * sizeof(int);
+                for (auto& s : p.scenarios) {
+                    bytes += s.test_intervals.capacity() * sizeof(double);
+                }
+                return bytes;
+            });
+
+            register_type<sc_core::sc_signal<double>>();
+            register_type<sc_core::sc_in<double>>();
+            register_type<sc_core::sc_out<double>>();
+            register_type<sc_core::sc_port<sc_core::sc_signal_in_if<double>, 0, sc_core::SC_ONE_OR_MORE_BOUND>>();
+            register_type<sc_core::sc_port<sc_core::sc_signal_inout_if<double>, 0, sc_core::SC_ZERO_OR_MORE_BOUND>>();
+            register_type<sc_core::sc_port<sc_core::sc_signal_in_if<double>, 1, sc_core::SC_ZERO_OR_MORE_BOUND>>();
+            register_type<sc_hw_metrics::sc_latent_in>([](const sc_core::sc_object& object) {
+                return static_cast<const sc_hw_metrics::sc_latent_in&>(object).test_intervals.capacity() * sizeof(double);
+            });
+            register_type<sc_hw_metrics::sc_split_out<double>>([](const sc_core::sc_object& object) {
+                return static_cast<const sc_hw_metrics::sc_split_out<double>&>(object).split_rates.capacity() * sizeof(double);
+            });
+
+            register_type<sc_fta::ccf_group>([](const sc_core::sc_object& object) {
+                return static_cast<const sc_fta::ccf_group&>(object).coefficients.capacity() * sizeof(double);
+            });
+            register_type<sc_core::sc_signal<sc_fta::prob>>();
+            register_type<sc_core::sc_in<sc_fta::prob>>();
+            register_type<sc_core::sc_out<sc_fta::prob>>();
+        }
+
+        template <class T>
+        void register_type(std::function<std::size_t(const sc_core::sc_object&)> heap = nullptr)
+        {
+            types[std::type_index(typeid(T))] = type_info{sizeof(T), std::move(heap)};
+        }
+
+        void end_of_elaboration() override
+        {
+            entries.clear();
+
+            for (auto* object : sc_core::sc_get_top_level_objects()) {
+                walk(object, 0);
+            }
+
+            report(std::cout);
+
+            if (!csv_path.empty()) {
+                std::ofstream csv(csv_path);
+                write_csv(csv);
+            }
+        }
+
+        // Per type totals followed by the subtree sizes of all modules
+        void report(std::ostream& os) const
+        {
+            struct total { std::size_t count = 0; std::size_t bytes = 0; bool registered = true; };
+            std::map<std::string, total> totals;
+            std::size_t all = 0;
+
+            for (auto& e : entries) {
+                auto& t = totals[e.type];
+                t.count++;
+                t.bytes += e.self_bytes + e.heap_bytes;
+                t.registered = e.registered;
+                all += e.self_bytes + e.heap_bytes;
+            }
+
+            os << "MEMORY: " << all << " bytes in " << entries.size() << " objects" << std::endl;
+
+            for (auto& [type, t] : totals) {
+                os << "  " << std::setw(12) << t.bytes << " " << std::setw(8) << t.count << "x " << type
+                   << (t.registered ? "" : " (size unknown)") << std::endl;
+            }
+
+            for (auto& e : entries) {
+                if (e.kind == "sc_module") {
+                    os << "  " << std::string(2 * e.depth, ' ') << e.name << ": " << e.subtree_bytes << std::endl;
+                }
+            }
+        }
+
+        void write_csv(std::ostream& os) const
+        {
+            os << "name,type,kind,depth,registered,self_bytes,heap_bytes,subtree_bytes" << std::endl;
+
+            for (auto& e : entries) {
+                os << quote(e.name) << "," << quote(e.type) << "," << e.kind << "," << e.depth << ","
+                   << e.registered << "," << e.self_bytes << "," << e.heap_bytes << "," << e.subtree_bytes << std::endl;
+            }
+        }
+
+    private:
+
+        struct type_info
+        {
+            std::size_t size;
+            std::function<std::size_t(const sc_core::sc_object&)> heap;
+        };
+
+        std::string csv_path;
+        std::map<std::type_index, type_info> types;
+
+        // Short strings are stored inside the string object itself
+        static std::size_t string_bytes(const std::string& s)
+        {
+            auto* begin = reinterpret_cast<const char*>(&s);
+            bool local = (s.data() >= begin) && (s.data() < begin + sizeof(s));
+            return local ? 0 : s.capacity() + 1;
+        }
+
+        // CSV field in quotes, quotes inside doubled
+        static std::string quote(const std::string& s)
+        {
+            std::string q = "\"";
+            for (char c : s) {
+                q += (c == '"') ? "\"\"" : std::string(1, c);
+            }
+            return q + "\"";
+        }
+
+        std::size_t size_of(const sc_core::sc_object* object) const
+        {
+            auto it = types.find(std::type_index(typeid(*object)));
+            return (it == types.end()) ? 0 : it->second.size;
+        }
+
+        std::size_t walk(sc_core::sc_object* object, int depth)
+        {
+            auto it = types.find(std::type_index(typeid(*object)));
+            bool registered = (it != types.end());
+            std::size_t index = entries.size();
+
+            entries.push_back(entry{object->name(), demangle(typeid(*object).name()), object->kind(), depth,
+                                    registered, 0, 0, 0});
+
+            std::size_t size = registered ? it->second.size : 0;
+            std::size_t self = size;
+            std::size_t heap = std::strlen(object->name()) + 1;
+
+            if (registered && it->second.heap) {
+                heap += it->second.heap(*object);
+            }
+
+            if (auto* port = dynamic_cast<sc_core::sc_port_base*>(object)) {
+                heap += std::size_t(port->bind_count()) * sizeof(sc_core::sc_interface*);
+            }
+
+            // Children that are data members are already part of sizeof
+            auto* begin = static_cast<const char*>(dynamic_cast<const void*>(object));
+            std::size_t subtree = 0;
+
+            for (auto* child : object->get_child_objects()) {
+                auto* address = static_cast<const char*>(dynamic_cast<const void*>(child));
+                std::size_t child_size = size_of(child);
+
+                if (address >= begin && address + child_size <= begin + size) {
+                    self -= child_size;
+                }
+
+                subtree += walk(child, depth + 1);
+            }
+
+            entries[index].self_bytes = self;
+            entries[index].heap_bytes = heap;
+            entries[index].subtree_bytes = subtree + self + heap;
+
+            return entries[index].subtree_bytes;
+        }
+    };
+}
+
+#endif // SC_MEMORY_REPORT_H
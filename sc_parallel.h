@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+
+#ifndef SC_PARALLEL_H
+#define SC_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops
+// tasks at the back and steals from the front of the other deques when its
+// own one is empty. Threads that wait for a parallel_for help executing
+// tasks, so nested parallel_for calls cannot deadlock, and sleep once all
+// tasks are taken. An exception of a task is thrown by parallel_for.
+
+namespace sc_parallel {
+
+    class thread_pool {
+
+    public:
+
+        explicit thread_pool(unsigned threads = std::thread::hardware_concurrency()) {
+            threads = std::max(threads, 1u);
+
+            // Queue 0 belongs to threads outside of the pool
+            for (unsigned i = 0; i < threads; i++) {
+                queues.push_back(std::make_unique<queue>());
+            }
+
+            for (unsigned i = 1; i < threads; i++) {
+                workers.emplace_back([this, i]() { work(i); });
+            }
+        }
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                stop = true;
+            }
+            wake.notify_all();
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // Number of threads that execute tasks, including the caller
+        unsigned size() const {
+            return queues.size();
+        }
+
+        // Calls f(first, last) for chunks of at most grain indices of
+        // [begin, end) and returns when all chunks are done
+        template <class F>
+        void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F&& f) {
+            if (begin >= end) {
+                return;
+            }
+
+            grain = std::max<std::size_t>(grain, 1);
+
+            if (end - begin <= grain || queues.size() == 1) {
+                f(begin, end);
+                return;
+            }
+
+            group g;
+            g.remaining = (end - begin + grain - 1) / grain;
+
+            for (std::size_t first = begin; first < end; first += grain) {
+                std::size_t last = std::min(first + grain, end);
+                push([&f, &g, first, last]() {
+                    std::exception_ptr error;
+                    try {
+                        f(first, last);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    g.done(error);
+                });
+            }
+
+            // Help while there are tasks, sleep when all are taken
+            while (!g.finished()) {
+                if (!run_one()) {
+                    std::unique_lock<std::mutex> lock(g.mutex);
+                    g.all_done.wait(lock, [&g]() { return g.remaining == 0; });
+                }
+            }
+
+            // The first exception of a chunk is thrown on the calling thread
+            // after all chunks have ended
+            std::lock_guard<std::mutex> lock(g.mutex);
+            if (g.error) {
+                std::rethrow_exception(g.error);
+            }
+        }
+
+        // Runs f(i) for every i in [0, count), one task per index
+        template <class F>
+        void parallel_for(std::size_t count, F&& f) {
+            parallel_for(0, count, 1, [&f](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    f(i);
+                }
+            });
+        }
+
+    private:
+
+        // Chunks of one parallel_for. The counter only changes under the
+        // mutex, so the caller cannot return while a task still uses it.
+        struct group
+        {
+            std::mutex mutex;
+            std::condition_variable all_done;
+            std::size_t remaining = 0;
+            std::exception_ptr error;
+
+            void done(std::exception_ptr e) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (e && !error) {
+                    error = e;
+                }
+                if (--remaining == 0) {
+                    all_done.notify_all();
+                }
+            }
+
+            bool finished() {
+                std::lock_guard<std::mutex> lock(mutex);
+                return remaining == 0;
+            }
+        };
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> pending{0};
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        bool stop = false;
+
+        static thread_local const thread_pool* current_pool;
+        static thread_local unsigned current_index;
+
+        unsigned own_index() const {
+            return (current_pool == this) ? current_index : 0;
+        }
+
+        void push(std::function<void()> task) {
+            queue& q = *queues[own_index()];
+            {
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(std::move(task));
+            }
+            pending.fetch_add(1, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+            }
+            wake.notify_one();
+        }
+
+        bool pop(unsigned index, bool back, std::function<void()>& task) {
+            queue& q = *queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+
+            if (q.tasks.empty()) {
+                return false;
+            }
+
+            if (back) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            return true;
+        }
+
+        bool run_one() {
+            unsigned index = own_index();
+            std::function<void()> task;
+            bool found = pop(index, true, task);
+
+            for (unsigned i = 1; !found && i < queues.size(); i++) {
+                found = pop((index + i) % queues.size(), false, task);
+            }
+
+            if (found) {
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+            }
+            return found;
+        }
+
+        void work(unsigned index) {
+            current_pool = this;
+            current_index = index;
+
+            while (true) {
+                if (run_one()) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                wake.wait(lock, [this]() { return stop || pending.load(std::memory_order_acquire) != 0; });
+
+                if (stop) {
+                    return;
+                }
+            }
+        }
+    };
+
+    inline thread_local const thread_pool* thread_pool::current_pool = nullptr;
+    inline thread_local unsigned thread_pool::current_index = 0;
+}
+
+#endif // SC_PARALLEL_H
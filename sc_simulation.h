@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024, Fraunhofer IESE
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER
+ * OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors:
+ *    Matthias Jung
+ */
+
+#ifndef SC_SIMULATION_H
+#define SC_SIMULATION_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <systemc>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Elaborating and running several independent models from one process. The
+// SystemC kernel keeps all objects, processes and the simulation time in one
+// global simulation context that cannot be elaborated twice, and IEEE 1666
+// has no way to reset it. Every model therefore runs in a forked copy of the
+// calling process, which elaborates it in the untouched context, runs it and
+// sends back the values the model returns:
+//
+//   for (double dc : {0.9, 0.99}) {
+//       auto values = sc_simulation::isolated([dc]() {
+//           sc_hw_metrics::basic_event e("e", 1000.0);
+//           ...
+//           sc_start();
+//           return std::vector<double>{a.spfm, a.lfm};
+//       });
+//   }
+//
+// A fork needs no new process image and no dynamic loader startup. The
+// calling process must not elaborate a model itself before, and changes the
+// model makes to memory, e.g. to a shared graph, are not seen by the caller.
+
+namespace sc_simulation {
+
+    // Runs the model in a child process and returns its values. A model that
+    // throws, exits or crashes is reported as an error.
+    inline std::vector<double> isolated(const std::function<std::vector<double>()>& model)
+    {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            SC_REPORT_ERROR("SIMULATION", "Cannot create a pipe");
+            return {};
+        }
+
+        // Buffered output would be written twice otherwise
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        pid_t child = ::fork();
+        if (child < 0) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+            SC_REPORT_ERROR("SIMULATION", "Cannot fork");
+            return {};
+        }
+
+        if (child == 0) {
+            ::close(fds[0]);
+            int status = 0;
+            try {
+                std::vector<double> values = model();
+                const char* data = reinterpret_cast<const char*>(values.data());
+                std::size_t size = values.size() * sizeof(double);
+                while (size > 0) {
+                    ssize_t n = ::write(fds[1], data, size);
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        status = 2;
+                        break;
+                    }
+                    data += n;
+                    size -= std::size_t(n);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                status = 1;
+            } catch (...) {
+                status = 1;
+            }
+            ::close(fds[1]);
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+            // The kernel of the child is not torn down
+            ::_exit(status);
+        }
+
+        ::close(fds[1]);
+        std::string data;
+        char buffer[4096];
+        for (;;) {
+            ssize_t n = ::read(fds[0], buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            data.append(buffer, std::size_t(n));
+        }
+        ::close(fds[0]);
+
+        int status = 0;
+        while (::waitpid(child, &status, 0) < 0 && errno == EINTR) {
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || data.size() % sizeof(double) != 0) {
+            SC_REPORT_ERROR("SIMULATION", "The model failed in its child process");
+            return {};
+        }
+
+        std::vector<double> values(data.size() / sizeof(double));
+        std::memcpy(values.data(), data.data(), data.size());
+        return values;
+    }
+}
+
+#endif // SC_SIMULATION_H
@@ -0,0 +1,35 @@
+# The DRAM model exists as SystemC modules (dram-metrics-refactored), as
+# graph (dram-graph-model.h, also used by dram-sweep and plots.py), in
+# linear form (dram-metrics-static) and as stages (dram-metrics-stages).
+# Runs all of them for several DRAM_FIT values and fails if the printed
+# metrics differ from those of the SystemC model.
+#
+#   cmake -DREFERENCE=<exe> -DMODELS=<exe>,<exe>,... -P dram-models.cmake
+
+string(REPLACE "," ";" MODELS "${MODELS}")
+
+function(metrics executable fit result)
+    execute_process(COMMAND ${executable} ${fit} OUTPUT_VARIABLE output RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "${executable} ${fit} failed: ${status}")
+    endif()
+    set(values "")
+    foreach(metric RES LAT SPFM LFM ASIL)
+        if(NOT output MATCHES "(^|\n)${metric}: +([^ \n]+)")
+            message(FATAL_ERROR "${executable} ${fit} prints no ${metric}")
+        endif()
+        list(APPEND values "${metric}=${CMAKE_MATCH_2}")
+    endforeach()
+    set(${result} "${values}" PARENT_SCOPE)
+endfunction()
+
+foreach(fit 0.01 100 2300 100000)
+    metrics(${REFERENCE} ${fit} expected)
+    foreach(model ${MODELS})
+        metrics(${model} ${fit} actual)
+        if(NOT actual STREQUAL expected)
+            message(FATAL_ERROR "DRAM_FIT=${fit}: ${model} gives ${actual}, ${REFERENCE} gives ${expected}")
+        endif()
+    endforeach()
+    message(STATUS "DRAM_FIT=${fit}: ${expected}")
+endforeach()
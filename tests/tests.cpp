@@ -1,7 +1,31 @@
 #include <gtest/gtest.h>
 #include <systemc.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
 #include "../sc_fta.h"
 #include "../sc_hw_metrics.h"
+#include "../sc_hw_metrics_interval.h"
+#include "../sc_hw_markov.h"
+#include "../sc_columnar_trace.h"
+#include "../sc_simulation.h"
+#include "../sc_arrow_ipc.h"
+#include "../sc_memory_report.h"
+#include "../sc_hw_graph.h"
+#include "../sc_hw_replica.h"
+#include "../sc_hw_server.h"
+#include "../sc_hw_sweep.h"
+#include "../sc_hw_dse.h"
+#include "../sc_hw_cache.h"
+#include "../sc_hw_solve.h"
+#include "../sc_hw_stochastic.h"
+#include "../sc_hw_stage.h"
+#include "../sc_hw_static.h"
+#include "../sc_ecc.h"
 
 TEST(prob, and) {
     sc_fta::prob a(0.5);
@@ -142,6 +166,59 @@ TEST(cft, hierarchy) {
     EXPECT_EQ(s3.read(), 0.75);
 }
 
+TEST(cft, ccf_models) {
+    auto consistent = [](const sc_fta::ccf_model& model) {
+        double total = 0.0;
+        for (std::size_t k = 1; k <= model.size(); k++) {
+            total += sc_fta::binomial(model.size() - 1, k - 1) * model.fractions[k - 1];
+        }
+        return total;
+    };
+
+    auto beta = sc_fta::beta_factor(4, 0.1);
+    auto mgl = sc_fta::multiple_greek_letters(4, {0.1, 0.4, 0.5});
+    auto alpha = sc_fta::alpha_factor({0.95, 0.03, 0.015, 0.005});
+
+    EXPECT_DOUBLE_EQ(consistent(beta), 1.0);
+    EXPECT_DOUBLE_EQ(consistent(mgl), 1.0);
+    EXPECT_DOUBLE_EQ(consistent(alpha), 1.0);
+    EXPECT_DOUBLE_EQ(consistent(sc_fta::alpha_factor({0.95, 0.03, 0.015, 0.005}, true)), 1.0);
+
+    // The alphas are shares of all failure events of the group
+    EXPECT_DEATH(sc_fta::alpha_factor({0.95, 0.03, 0.015}), "alpha_sum");
+    EXPECT_DEATH(sc_fta::alpha_factor({0.5, 0.3, 0.3}, true), "alpha_sum");
+
+    // Beta factor is MGL with all further factors 1
+    auto all = sc_fta::multiple_greek_letters(4, {0.1, 1.0, 1.0});
+    for (std::size_t k = 0; k < 4; k++) {
+        EXPECT_NEAR(all.fractions[k], beta.fractions[k], 1e-15);
+    }
+    EXPECT_DOUBLE_EQ(mgl.fractions[1], 0.1 * 0.6 / 3);
+    EXPECT_DOUBLE_EQ(mgl.fractions[3], 0.1 * 0.4 * 0.5);
+}
+
+TEST(cft, ccf_group) {
+    double qt = 1e-3;
+    auto model = sc_fta::multiple_greek_letters(4, {0.1, 0.4, 0.5});
+    double q1 = model.fractions[0] * qt, q2 = model.fractions[1] * qt;
+    double q3 = model.fractions[2] * qt, q4 = model.fractions[3] * qt;
+
+    sc_signal<sc_fta::prob> total("total", qt), all("all"), two("two");
+    sc_fta::ccf_group g4("g4", model, 4);
+    sc_fta::ccf_group g2("g2", model, 2);
+    g4.input.bind(total);
+    g4.output.bind(all);
+    g2.input.bind(total);
+    g2.output.bind(two);
+
+    sc_start();
+
+    // Partitions of the group into disjoint events
+    EXPECT_NEAR(all.read().value, q4 + 4 * q3 * q1 + 3 * q2 * q2 + 6 * q2 * q1 * q1 + std::pow(q1, 4), 1e-18);
+    EXPECT_NEAR(two.read().value, 6 * q1 * q1 + 6 * q2 + 4 * q3 + q4, 1e-15);
+    EXPECT_GT(all.read().value, std::pow(qt, 4) * 1e3);
+}
+
 // Hardware Metrics:
 
 TEST(hw_metric, basic_event) {
@@ -220,9 +297,1256 @@ TEST(hw_metric, sum) {
     EXPECT_DOUBLE_EQ(o.read(), 20.0);
 }
 
+TEST(hw_metric, wide_sum) {
+    // One large rate and many small ones, added pairwise
+    sc_vector<sc_signal<double>> i("i", 1000);
+    sc_signal<double> o("o");
+
+    sc_hw_metrics::sum s("sum");
+
+    std::vector<double> values;
+    long double exact = 0.0;
+    double naive = 0.0;
+    for (std::size_t k = 0; k < i.size(); k++) {
+        values.push_back(k == 0 ? 5e9 : 0.01 * (1 + k % 7));
+        exact += values.back();
+        naive += values.back();
+        i[k].write(values.back());
+        s.inputs.bind(i[k]);
+    }
+    s.output.bind(o);
+
+    sc_start();
+
+    EXPECT_EQ(o.read(), sc_hw_metrics::pairwise_sum(values.data(), values.size()));
+    EXPECT_NEAR(o.read(), double(exact), 1e-5);
+    EXPECT_GT(std::abs(naive - double(exact)), 1e-5);
+}
+
+TEST(hw_metric, asil) {
+    sc_signal<double> r("r", 5.0);
+    sc_signal<double> l("l", 50.0);
+
+    sc_hw_metrics::asil a("asil", 1000.0);
+
+    a.residual.bind(r);
+    a.latent.bind(l);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(a.spfm, 99.5);
+    EXPECT_EQ(a.asil_level, "ASIL-D");
+}
+
+TEST(hw_metric, profile_event) {
+    sc_signal<double> o("o");
+    sc_signal<double> r("r", 5.0);
+    sc_signal<double> l("l", 50.0);
+
+    // The second segment does not change the rate and is dropped
+    sc_hw_metrics::profile_event e("e", {{SC_ZERO_TIME, 10.0},
+                                         {sc_time(5, SC_NS), 10.0},
+                                         {sc_time(10, SC_NS), 20.0},
+                                         {sc_time(20, SC_NS), 500.0}});
+    sc_hw_metrics::asil a("asil", 1000.0);
+
+    e.output.bind(o);
+    a.residual.bind(r);
+    a.latent.bind(l);
+    a.total_rate.bind(o);
+
+    EXPECT_EQ(e.segments.size(), 3u);
+
+    sc_start(sc_time(7, SC_NS));
+    EXPECT_DOUBLE_EQ(o.read(), 10.0);
+
+    sc_start(sc_time(5, SC_NS));
+    EXPECT_DOUBLE_EQ(o.read(), 20.0);
+
+    sc_start();
+    EXPECT_DOUBLE_EQ(o.read(), 500.0);
+    EXPECT_DOUBLE_EQ(a.spfm, 99.0);
+    EXPECT_EQ(sc_time_stamp(), sc_time(20, SC_NS));
+
+    auto sampled = sc_hw_metrics::sample_rate([](const sc_time& t) { return t.to_seconds(); }, sc_time(4, SC_SEC), 2);
+    ASSERT_EQ(sampled.size(), 2u);
+    EXPECT_EQ(sampled[1].start, sc_time(2, SC_SEC));
+    EXPECT_DOUBLE_EQ(sampled[1].rate, 3.0);
+}
+
+TEST(hw_metric, profile_event_order) {
+    // The repeated rate at 5 s is dropped but its start still counts
+    std::vector<sc_hw_metrics::rate_segment> profile = {
+        {sc_time(0, SC_SEC), 1.0}, {sc_time(5, SC_SEC), 1.0}, {sc_time(3, SC_SEC), 2.0}};
+    EXPECT_DEATH(sc_hw_metrics::profile_event("p", profile), "increasing");
+
+    std::vector<sc_hw_metrics::rate_segment> zero = {{sc_time(2, SC_SEC), 0.0}, {sc_time(1, SC_SEC), 1.0}};
+    EXPECT_DEATH(sc_hw_metrics::profile_event("z", zero), "increasing");
+}
+
+TEST(hw_metric, pmhf) {
+    sc_signal<double> r("r", 5.0);
+    sc_signal<double> never("never", 10.0);
+    sc_signal<double> tested("tested", 20.0);
+
+    sc_hw_metrics::pmhf p("pmhf", 1000.0, {{10000.0, {}}, {50.0, {}}, {10000.0, {1.0, 1.0}}});
+
+    p.residual.bind(r);
+    p.latent.bind(never, 0.0);
+    p.latent.bind(tested, 100.0);
+
+    sc_start();
+
+    // 1e-9 * 1000 * (10 * 10000 / 2 + 20 * 100 / 2)
+    ASSERT_EQ(p.values.size(), 3);
+    EXPECT_DOUBLE_EQ(p.values[0], 5.0 + 0.051);
+    EXPECT_DOUBLE_EQ(p.values[1], 5.0 + 1e-6 * (10 * 25.0 + 20 * 25.0));
+    EXPECT_DOUBLE_EQ(p.values[2], 5.0 + 1e-6 * 30 * 0.5);
+    EXPECT_EQ(p.classes[0], 4);
+}
+
+// Interval Hardware Metrics:
+
+TEST(hw_metric_interval, arithmetic) {
+    sc_hw_metrics_interval::interval a(1.0, 2.0);
+    sc_hw_metrics_interval::interval b(-1.0, 3.0);
+
+    EXPECT_EQ(a + b, sc_hw_metrics_interval::interval(0.0, 5.0));
+    EXPECT_EQ(a - b, sc_hw_metrics_interval::interval(-2.0, 3.0));
+    EXPECT_EQ(a * b, sc_hw_metrics_interval::interval(-2.0, 6.0));
+    EXPECT_EQ(1.0 - a, sc_hw_metrics_interval::interval(-1.0, 0.0));
+}
+
+TEST(hw_metric_interval, coverage) {
+    sc_signal<sc_hw_metrics_interval::interval> i("i", sc_hw_metrics_interval::interval(100.0, 200.0));
+    sc_signal<sc_hw_metrics_interval::interval> o("o");
+    sc_signal<sc_hw_metrics_interval::interval> l("l");
+
+    sc_hw_metrics_interval::coverage m("m", sc_hw_metrics_interval::interval(0.9, 0.99), 0.5);
+
+    m.input.bind(i);
+    m.output.bind(o);
+    m.latent.bind(l);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(o.read().lower, 1.0);
+    EXPECT_DOUBLE_EQ(o.read().upper, 20.0);
+    EXPECT_DOUBLE_EQ(l.read().lower, 50.0);
+    EXPECT_DOUBLE_EQ(l.read().upper, 100.0);
+}
+
+TEST(hw_metric_interval, split) {
+    sc_signal<sc_hw_metrics_interval::interval> i("i", 100.0);
+    sc_signal<sc_hw_metrics_interval::interval> o1("o1");
+    sc_signal<sc_hw_metrics_interval::interval> o2("o2");
+
+    sc_hw_metrics_interval::split s("s");
+
+    s.input.bind(i);
+    s.outputs.bind(o1, sc_hw_metrics_interval::interval(0.8, 0.9));
+    s.outputs.bind(o2, 0.1);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(o1.read().lower, 80.0);
+    EXPECT_DOUBLE_EQ(o1.read().upper, 90.0);
+    EXPECT_DOUBLE_EQ(o2.read().lower, 10.0);
+    EXPECT_DOUBLE_EQ(o2.read().upper, 10.0);
+}
+
+TEST(hw_metric_interval, asil) {
+    sc_signal<sc_hw_metrics_interval::interval> r("r", sc_hw_metrics_interval::interval(5.0, 50.0));
+    sc_signal<sc_hw_metrics_interval::interval> l("l", 10.0);
+
+    sc_hw_metrics_interval::asil a("asil", 1000.0);
+
+    a.residual.bind(r);
+    a.latent.bind(l);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(a.spfm.lower, 95.0);
+    EXPECT_DOUBLE_EQ(a.spfm.upper, 99.5);
+    EXPECT_EQ(a.guaranteed_level, "ASIL-B");
+    EXPECT_EQ(a.possible_level, "ASIL-D");
+}
+
+TEST(hw_metric_interval, asil_unbounded) {
+    // The residual may reach the total, then there is no lower LFM bound
+    sc_signal<sc_hw_metrics_interval::interval> r("r", sc_hw_metrics_interval::interval(5.0, 1000.0));
+    sc_signal<sc_hw_metrics_interval::interval> l("l", 0.0);
+
+    sc_hw_metrics_interval::asil a("asil", sc_hw_metrics_interval::interval(500.0, 1000.0));
+
+    a.residual.bind(r);
+    a.latent.bind(l);
+
+    sc_start();
+
+    EXPECT_EQ(a.lfm.lower, -std::numeric_limits<double>::infinity());
+    EXPECT_DOUBLE_EQ(a.lfm.upper, 100.0);
+    EXPECT_EQ(a.guaranteed_level, "QM");
+}
+
+// Simulation:
+
+TEST(simulation, isolated) {
+    std::vector<double> spfm;
+
+    // Both models use the same names and start at time zero
+    for (double dc : {0.9, 0.99}) {
+        auto values = sc_simulation::isolated([dc]() {
+            sc_hw_metrics::basic_event e("e", 1000.0);
+            sc_hw_metrics::coverage c("c", dc, 0.5);
+            sc_hw_metrics::asil a("asil", 1000.0);
+            sc_signal<double> i("i"), r("r"), l("l");
+
+            e.output(i);
+            c.input(i);
+            c.output(r);
+            c.latent(l);
+            a.residual(r);
+            a.latent(l);
+
+            double start = sc_time_stamp().to_double();
+            sc_start();
+            return std::vector<double>{a.spfm, start};
+        });
+        ASSERT_EQ(values.size(), 2u);
+        spfm.push_back(values[0]);
+        EXPECT_EQ(values[1], 0.0);
+    }
+
+    EXPECT_NEAR(spfm[0], 90.0, 1e-9);
+    EXPECT_NEAR(spfm[1], 99.0, 1e-9);
+    EXPECT_TRUE(sc_get_top_level_objects().empty());
+
+    EXPECT_THROW(sc_simulation::isolated([]() -> std::vector<double> {
+        throw std::runtime_error("model failed");
+    }), sc_core::sc_report);
+}
+
+// Columnar Trace:
+
+TEST(columnar_trace, append) {
+    std::string path = testing::TempDir() + "columnar_trace_append.sct";
+    std::remove(path.c_str());
+
+    sc_signal<double> s("s", 1.0);
+    sc_fta::prob p(0.5);
+
+    for (int run = 0; run < 2; run++) {
+        sc_columnar_trace::trace_file tf(path);
+        sc_columnar_trace::sc_trace(&tf, s, "s");
+        sc_columnar_trace::sc_trace(&tf, p, "p");
+        tf.sample();
+        tf.sample();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Header with the 16 byte string table "s\0p.probability\0"
+    ASSERT_EQ(data.size(), 24 + 16 + 2 * (16 + 2 * 2 * 8));
+    EXPECT_EQ(data.substr(0, 8), "SCCOLTR1");
+    EXPECT_EQ(data.substr(24, 16), std::string("s\0p.probability\0", 16));
+    EXPECT_EQ(data.substr(40, 4), "ROWS");
+    EXPECT_EQ(data.substr(88, 4), "ROWS");
+
+    double values[4];
+    std::memcpy(values, &data[40 + 16], sizeof(values));
+    EXPECT_EQ(values[0], 1.0);
+    EXPECT_EQ(values[1], 1.0);
+    EXPECT_EQ(values[2], 0.5);
+    EXPECT_EQ(values[3], 0.5);
+}
+
+TEST(columnar_trace, mismatch) {
+    std::string path = testing::TempDir() + "columnar_trace_mismatch.sct";
+    std::remove(path.c_str());
+
+    double a = 1.0, b = 2.0;
+    {
+        sc_columnar_trace::trace_file tf(path);
+        tf.trace(a, "a");
+        tf.sample();
+    }
+
+    // Different columns: the rows are dropped with one error, the
+    // destructor has nothing left to flush
+    sc_columnar_trace::trace_file tf(path);
+    tf.trace(b, "b");
+    tf.sample();
+    EXPECT_THROW(tf.flush(), sc_core::sc_report);
+    EXPECT_NO_THROW(tf.flush());
+}
+
+TEST(arrow_ipc, batches) {
+    std::string path = testing::TempDir() + "arrow_ipc_batches.arrow";
+    double x = 0.0;
+    std::int64_t i = 0;
+    std::string level;
+
+    {
+        sc_arrow_ipc::file_writer out(path, 2);
+        out.column(x, "x");
+        out.column(i, "i");
+        out.column(level, "asil");
+
+        for (i = 0; i < 3; i++) {
+            x = 1.5 + i;
+            level = sc_hw_metrics::asil_levels[i];
+            out.sample();
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ASSERT_GT(data.size(), 16);
+    EXPECT_EQ(data.substr(0, 8), std::string("ARROW1\0\0", 8));
+    EXPECT_EQ(data.substr(8, 4), "\xFF\xFF\xFF\xFF");
+    EXPECT_EQ(data.substr(data.size() - 6), "ARROW1");
+
+    std::int32_t footer;
+    std::memcpy(&footer, &data[data.size() - 10], sizeof(footer));
+    EXPECT_EQ(footer % 8, 0);
+    EXPECT_EQ(data.substr(data.size() - 10 - footer - 8, 8), std::string("\xFF\xFF\xFF\xFF\0\0\0\0", 8));
+
+    // Two record batches, the values of the first one are contiguous
+    double first[] = {1.5, 2.5};
+    EXPECT_NE(data.find(std::string(reinterpret_cast<const char*>(first), sizeof(first))), std::string::npos);
+    EXPECT_NE(data.find("QMASIL-A"), std::string::npos);
+    EXPECT_NE(data.find("ASIL-B"), std::string::npos);
+}
+
+// Memory Report:
+
+TEST(memory_report, split) {
+    sc_signal<double> i("i", 100.0);
+    sc_signal<double> o1("o1");
+    sc_signal<double> o2("o2");
+
+    sc_hw_metrics::split s("s");
+
+    s.input.bind(i);
+    s.outputs.bind(o1, 0.87);
+    s.outputs.bind(o2, 0.13);
+
+    sc_memory_report::memory_report m("m");
+
+    sc_start();
+
+    auto e = std::find_if(m.entries.begin(), m.entries.end(), [](auto& e) { return e.name == "s"; });
+    ASSERT_NE(e, m.entries.end());
+    EXPECT_TRUE(e->registered);
+    EXPECT_EQ(e->type, "sc_hw_metrics::split");
+    EXPECT_EQ(e->self_bytes, sizeof(sc_hw_metrics::split) - sizeof(sc_in<double>) - sizeof(sc_hw_metrics::sc_split_out<double>));
+
+    auto o = std::find_if(m.entries.begin(), m.entries.end(), [](auto& e) { return e.type == "sc_hw_metrics::sc_split_out<double>"; });
+    ASSERT_NE(o, m.entries.end());
+    EXPECT_EQ(o->self_bytes, sizeof(sc_hw_metrics::sc_split_out<double>));
+    EXPECT_GE(o->heap_bytes, 2 * sizeof(double) + 2 * sizeof(sc_interface*));
+    EXPECT_GT(e->subtree_bytes, e->self_bytes + o->self_bytes + o->heap_bytes);
+
+    std::ostringstream csv;
+    m.entries[0].name = "a,\"b\"";
+    m.write_csv(csv);
+    std::string line = csv.str().substr(csv.str().find('\n') + 1);
+    EXPECT_EQ(line.substr(0, 10), "\"a,\"\"b\"\"\",");
+}
+
+// Graph Backend:
+
+TEST(hw_graph, primitives) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 100.0);
+    auto c = g.coverage("c", e, 0.83, 1.0 - 0.83);
+    auto s = g.split("s", e, {0.87, 0.13});
+    auto p = g.pass("p", s[1]);
+    auto o = g.sum("o", {s[0], p});
+    auto t = g.basic_event("t", 1000.0);
+    auto a = g.asil("a", g.basic_event("r", 5.0), g.basic_event("l", 50.0), t);
+
+    g.evaluate();
+
+    EXPECT_DOUBLE_EQ(g.read(c.output), 17.0);
+    EXPECT_DOUBLE_EQ(g.read(c.latent), 83.0);
+    EXPECT_DOUBLE_EQ(g.read(s[0]), 87.0);
+    EXPECT_DOUBLE_EQ(g.read(p), 13.0);
+    EXPECT_DOUBLE_EQ(g.read(o), 100.0);
+    EXPECT_DOUBLE_EQ(g.spfm(a), 99.5);
+    EXPECT_EQ(g.asil_level(a), "ASIL-D");
+    EXPECT_EQ(g.name(g.find("s")), "s");
+    EXPECT_GT(g.memory_bytes(), 0);
+}
+
+TEST(hw_graph, coefficient) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 100.0);
+    auto c = g.coverage("c", e, 0.5, 0.5);
+
+    g.evaluate();
+    EXPECT_DOUBLE_EQ(g.read(c.output), 50.0);
+
+    g.set_coefficient(g.find("c"), 0, 0.9);
+    g.set_coefficient(g.find("e"), 0, 200.0);
+    g.evaluate();
+    EXPECT_DOUBLE_EQ(g.read(c.output), 20.0);
+}
+
+TEST(hw_graph, interval) {
+    using sc_hw_metrics_interval::interval;
+    sc_hw_graph::interval_graph g;
+
+    auto e = g.basic_event("e", interval(100.0, 200.0));
+    auto c = g.coverage("c", e, interval(0.9, 0.99), 0.5);
+
+    g.evaluate();
+
+    EXPECT_DOUBLE_EQ(g.read(c.output).lower, 1.0);
+    EXPECT_DOUBLE_EQ(g.read(c.output).upper, 20.0);
+    EXPECT_DOUBLE_EQ(g.read(c.latent).lower, 50.0);
+}
+
+TEST(parallel, exception) {
+    sc_parallel::thread_pool pool(4);
+    std::atomic<int> done{0};
+
+    EXPECT_THROW(pool.parallel_for(100, [&](std::size_t i) {
+        if (i == 37) {
+            throw std::runtime_error("chunk");
+        }
+        done++;
+    }), std::runtime_error);
+    EXPECT_EQ(done, 99);
+
+    // The pool is still usable
+    pool.parallel_for(10, [&](std::size_t) { done++; });
+    EXPECT_EQ(done, 109);
+}
+
+TEST(hw_graph, parallel) {
+    sc_hw_graph::graph g;
+    std::vector<sc_hw_graph::value> residual;
+
+    for (int i = 0; i < 20000; i++) {
+        auto e = g.basic_event("e" + std::to_string(i), 1e-2 * (i % 97) + 1e3 * (i % 5));
+        auto s = g.split("s" + std::to_string(i), e, {0.3, 0.6});
+        auto c = g.coverage("c" + std::to_string(i), s[1], 0.9, 0.5);
+        residual.push_back(g.sum("r" + std::to_string(i), {s[0], c.output}));
+    }
+
+    auto r = g.sum("RESIDUAL", residual);
+
+    g.evaluate();
+    double serial = g.read(r);
+
+    // The same pairwise sum as sc_hw_metrics::sum
+    std::vector<double> inputs;
+    for (auto& v : residual) {
+        inputs.push_back(g.read(v));
+    }
+    EXPECT_EQ(serial, sc_hw_metrics::pairwise_sum(inputs.data(), inputs.size()));
+
+    for (unsigned threads : {2, 3, 4}) {
+        sc_parallel::thread_pool pool(threads);
+        g.evaluate(pool, 64);
+        EXPECT_EQ(g.read(r), serial);
+    }
+
+    sc_hw_graph::replicas replicas(g, 3);
+    replicas.evaluate();
+    EXPECT_EQ(replicas.read(r, 2), serial);
+
+    EXPECT_EQ(g.levels(), 5);
+}
+
+TEST(hw_graph, batch) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto l = g.pass("l", c.latent);
+    auto a = g.asil("ASIL", c.output, l, e);
+
+    double values[] = {0.9, 0.5,
+                       0.99, 0.9};
+    double spfm[2], lfm[2], residual[2], latent[2];
+
+    sc_hw_graph::evaluate_batch(g, a, {{"c", 0}, {"c", 1}}, values, 2, spfm, lfm, residual, latent);
+
+    EXPECT_DOUBLE_EQ(residual[0], 100.0);
+    EXPECT_DOUBLE_EQ(latent[0], 500.0);
+    EXPECT_DOUBLE_EQ(spfm[1], 99.0);
+    EXPECT_NEAR(residual[1], 10.0, 1e-9);
+    EXPECT_NEAR(latent[1], 100.0, 1e-9);
+    EXPECT_DOUBLE_EQ(g.coefficient(g.find("c"), 0), 0.9);
+}
+
+TEST(hw_static, fold) {
+    using namespace sc_hw_static;
+
+    using fit = split<input, 0.7, 0.3>;
+    using cov = coverage<output<fit, 0>, 0.9, 0.5>;
+    using res = sum<cov, output<fit, 1>, basic_event<10.0>>;
+    using model = asil<res, latent<cov>, input>;
+
+    static_assert(cov::value.a == 0.7 * (1 - 0.9));
+    static_assert(model::residual.b == 10.0);
+    static_assert(model::evaluate(1000.0).asil_class == 1);
+
+    sc_hw_graph::graph g;
+    auto e = g.basic_event("e", 1000.0);
+    auto s = g.split("s", e, {0.7, 0.3});
+    auto c = g.coverage("c", s[0], 0.9, 0.5);
+    auto r = g.sum("r", {c.output, s[1], g.basic_event("b", 10.0)});
+    auto a = g.asil("ASIL", r, c.latent, e);
+    g.evaluate();
+
+    metrics m = model::evaluate(1000.0);
+    EXPECT_NEAR(m.residual, g.read(r), 1e-9);
+    EXPECT_NEAR(m.latent, g.read(c.latent), 1e-9);
+    EXPECT_NEAR(m.spfm, g.spfm(a), 1e-9);
+    EXPECT_NEAR(m.lfm, g.lfm(a), 1e-9);
+}
+
+TEST(hw_stage, chain) {
+    using namespace sc_hw_stage;
+
+    stage a = stage("A").route(SBE, SBE, 1.0, 0.9, 0.5).route(DBE, SBE, 0.2).route(DBE, TBE, 0.8)
+                        .pass(MBE).latent_event(0.1);
+    stage b = stage("B").route(SBE, SBE, 0.5).exit(SBE, 0.5).route(TBE, MBE, 1.0, 0.5, 0.0)
+                        .pass(MBE).inject(WD, 10.0, 0.5, 0.5);
+    stage c = chain({a, b, stage::sink()});
+
+    error_vector input = {100.0, 10.0, 0.0, 1.0, 0.0, 0.0};
+    result ra = a.evaluate(input);
+    result rb = b.evaluate(ra.output);
+    result rc = c.evaluate(input);
+
+    double residual = ra.residual + rb.residual;
+    for (auto v : rb.output) {
+        residual += v;
+    }
+
+    EXPECT_DOUBLE_EQ(rc.residual, residual);
+    EXPECT_DOUBLE_EQ(rc.latent, ra.latent + rb.latent);
+    EXPECT_DOUBLE_EQ(rc.latent, 50.0 + 0.1 + 8.0 + 5.0);
+
+    sc_vector<sc_signal<double>> in("in", error_classes), out("out", error_classes);
+    sc_signal<double> res("res"), lat("lat");
+    transfer t("t", a.then(b));
+    for (std::size_t i = 0; i < error_classes; i++) {
+        in[i].write(input[i]);
+        t.inputs[i](in[i]);
+        t.outputs[i](out[i]);
+    }
+    t.residual(res);
+    t.latent(lat);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(out[MBE].read(), rb.output[MBE]);
+    EXPECT_DOUBLE_EQ(out[WD].read(), 5.0);
+    EXPECT_DOUBLE_EQ(res.read(), ra.residual + rb.residual);
+    EXPECT_DOUBLE_EQ(lat.read(), rc.latent);
+}
+
+TEST(hw_markov, uniformization) {
+    sc_hw_markov::ctmc c(2);
+    c.add(0, 1, 2.0, 0);
+
+    std::vector<double> p = c.transient({1.0, 0.0}, 3.0);
+    std::vector<double> o = c.occupancy({1.0, 0.0}, 3.0);
+    std::vector<double> n = c.counts({1.0, 0.0}, 3.0, 1);
+
+    EXPECT_NEAR(p[0], std::exp(-6.0), 1e-12);
+    EXPECT_NEAR(o[0], (1 - std::exp(-6.0)) / 2, 1e-12);
+    EXPECT_NEAR(o[0] + o[1], 3.0, 1e-12);
+    EXPECT_NEAR(n[0], 1 - std::exp(-6.0), 1e-12);
+    EXPECT_NEAR(c.net_flow({1.0, 0.0}, 3.0)[1], p[1], 1e-12);
+}
+
+TEST(hw_markov, scrubbing) {
+    // Without accumulation all rates pass, with rare scrubs SBEs become DBEs
+    auto fast = sc_hw_markov::scrubbed_rates(1000.0, 100.0, 10.0, 1e-3, 136e6);
+    auto slow = sc_hw_markov::scrubbed_rates(1000.0, 100.0, 10.0, 1e9, 136e6);
+
+    EXPECT_NEAR(fast.sbe, 1000.0, 1e-6);
+    EXPECT_NEAR(fast.dbe, 100.0, 1e-6);
+    EXPECT_NEAR(fast.mbe, 10.0, 1e-6);
+    EXPECT_LT(slow.sbe, 1000.0);
+    EXPECT_GT(slow.dbe, 100.0);
+
+    // SBEs only in a single word: the word leaves the clean state once per
+    // interval, and stays an SBE until the second fault with probability
+    // s / (a - s) * (exp(-s t) - exp(-a t))
+    double s = 0.5, a = s * 135 / 136, t = 2.0;
+    auto only = sc_hw_markov::scrubbed_rates(s * 1e9, 0.0, 0.0, t, 136);
+    EXPECT_NEAR((only.sbe + only.dbe + only.mbe) * t * 1e-9, -std::expm1(-s * t), 1e-10);
+    EXPECT_NEAR(only.sbe * t * 1e-9, s / (a - s) * (std::exp(-s * t) - std::exp(-a * t)), 1e-10);
+
+    sc_signal<double> sbe("sbe", 1000.0), dbe("dbe", 100.0), mbe("mbe", 10.0), wd("wd", 5.0);
+    sc_signal<double> o_sbe("o_sbe"), o_dbe("o_dbe"), o_mbe("o_mbe"), o_wd("o_wd");
+    sc_hw_markov::scrubbed_memory m("m", 1e9, 136e6);
+    m.sbe_rate(sbe);
+    m.dbe_rate(dbe);
+    m.mbe_rate(mbe);
+    m.wd_rate(wd);
+    m.sbe(o_sbe);
+    m.dbe(o_dbe);
+    m.mbe(o_mbe);
+    m.wd(o_wd);
+
+    sc_start();
+
+    EXPECT_DOUBLE_EQ(o_dbe.read(), slow.dbe);
+    EXPECT_DOUBLE_EQ(o_wd.read(), 5.0);
+}
+
+TEST(ecc, patterns) {
+    sc_parallel::thread_pool pool(2);
+
+    // The (7,4) Hamming code is perfect: every DBE becomes a TBE
+    sc_ecc::code hamming = sc_ecc::code::hamming(4);
+    sc_ecc::analysis dbe = sc_ecc::analyze(hamming, 2, pool);
+    EXPECT_EQ(hamming.n, 7u);
+    EXPECT_EQ(dbe.patterns, 21u);
+    EXPECT_DOUBLE_EQ(dbe.miscorrected, 1.0);
+    EXPECT_DOUBLE_EQ(dbe.rates({2, 3})[1], 1.0);
+
+    // SEC-DED corrects all SBEs and detects all DBEs
+    sc_ecc::code hsiao = sc_ecc::code::hsiao(64);
+    EXPECT_EQ(hsiao.n, 72u);
+    EXPECT_EQ(hsiao.parity_bits(), 8u);
+    EXPECT_DOUBLE_EQ(sc_ecc::analyze(hsiao, 1, pool).corrected, 1.0);
+    EXPECT_DOUBLE_EQ(sc_ecc::analyze(hsiao, 2, pool).detected, 1.0);
+
+    sc_ecc::analysis tbe = sc_ecc::analyze(hsiao, 3, pool);
+    EXPECT_EQ(tbe.patterns, 59640u);
+    EXPECT_NEAR(tbe.detected + tbe.miscorrected, 1.0, 1e-12);
+    EXPECT_DOUBLE_EQ(tbe.miscorrected, tbe.rates({4})[0]);
+
+    // Bursts of length 3: first and last bit set, the middle one either way
+    EXPECT_EQ(sc_ecc::analyze_bursts(hsiao, 3, pool).patterns, 140u);
+
+    // An uncorrected DBE in the 72 bits lands in the 64 data bits
+    std::vector<double> trim = sc_ecc::trim_rates(72, 64, 2);
+    EXPECT_NEAR(trim[0], 64.0 * 8.0 / 2556.0, 1e-12);
+    EXPECT_NEAR(trim[1], 2016.0 / 2556.0, 1e-12);
+    EXPECT_NEAR(sc_ecc::analyze(hsiao, 2, pool).observed_rates(2)[1], trim[1], 1e-12);
+}
+
+TEST(ecc, search) {
+    sc_parallel::thread_pool pool(2);
+    sc_ecc::code start = sc_ecc::code::hamming(8);
+
+    sc_ecc::search_options options;
+    options.chains = 3;
+    options.iterations = 2000;
+    std::vector<sc_ecc::candidate> best = sc_ecc::search(start, options, pool);
+
+    ASSERT_EQ(best.size(), 3u);
+    EXPECT_LE(best[0].codewords, best[2].codewords);
+    EXPECT_LE(best[0].codewords, sc_ecc::codeword_counter(start).codewords());
+
+    // Every weight-3 codeword miscorrects 3 of the 66 DBEs of the (12,8) code
+    EXPECT_NEAR(best[0].miscorrection.miscorrected * 66, 3.0 * best[0].codewords, 1e-9);
+
+    // Incremental counts agree with a fresh count, 0xf is unused in start
+    sc_ecc::codeword_counter counter(start);
+    counter.replace(0, 0xf);
+    EXPECT_EQ(counter.codewords(), sc_ecc::codeword_counter(sc_ecc::code(start.k, counter.columns, start.type)).codewords());
+    EXPECT_EQ(sc_ecc::codeword_counter(best[0].c).codewords(), best[0].codewords);
+}
+
+TEST(hw_cache, subtrees) {
+    std::string path = testing::TempDir() + "hw_cache_subtrees.bin";
+    std::remove(path.c_str());
+
+    sc_hw_graph::graph g;
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto o = g.basic_event("o", 100.0);
+    auto oc = g.coverage("oc", o, 0.99, 1.0);
+    auto r = g.sum("r", {c.output, oc.output});
+    auto l = g.sum("l", {c.latent, oc.latent});
+    auto t = g.sum("t", {e, o});
+    auto a = g.asil("ASIL", r, l, t);
+    g.compile();
+    std::vector<sc_hw_graph::value> outputs = {r, l, g.output(a, 0), g.output(a, 1)};
+
+    {
+        sc_hw_cache::store cache(path);
+        sc_hw_cache::cached_graph cached(g, cache);
+        auto s = cached.evaluate(outputs);
+        EXPECT_EQ(s.evaluated, g.size());
+        EXPECT_EQ(s.hashed, g.size());
+        EXPECT_EQ(cached.hashes(), sc_hw_cache::node_hashes(g));
+
+        double spfm = g.spfm(a);
+        g.evaluate();
+        EXPECT_EQ(g.spfm(a), spfm);
+
+        // A repeated point is not hashed again, the requested nodes are
+        // still current
+        s = cached.evaluate(outputs);
+        EXPECT_EQ(s.hashed, 0u);
+        EXPECT_EQ(s.evaluated, 0u);
+        EXPECT_EQ(s.loaded, 0u);
+        EXPECT_EQ(s.current, 3u);
+
+        // Only the nodes downstream of the changed coverage are hashed and
+        // evaluated
+        cached.set_coefficient(g.find("c"), 0, 0.99);
+        s = cached.evaluate(outputs);
+        EXPECT_EQ(s.hashed, 4u);
+        EXPECT_EQ(s.evaluated, 4u);
+        EXPECT_EQ(s.current, 3u);
+        EXPECT_NEAR(g.read(r), 10.0 + 1.0, 1e-9);
+        EXPECT_EQ(cached.hashes(), sc_hw_cache::node_hashes(g));
+
+        // Back to a known point: loaded, nothing evaluated
+        cached.set_coefficient(g.find("c"), 0, 0.9);
+        s = cached.evaluate(outputs);
+        EXPECT_EQ(s.evaluated, 0u);
+        EXPECT_EQ(s.loaded, 3u);
+        EXPECT_NEAR(g.read(r), 100.0 + 1.0, 1e-9);
+        EXPECT_EQ(cached.hashes(), sc_hw_cache::node_hashes(g));
+        cached.set_coefficient(g.find("c"), 0, 0.99);
+        cached.evaluate(outputs);
+    }
+
+    // Both points are reused from disk, names do not matter
+    sc_hw_graph::graph h;
+    auto he = h.basic_event("E", 1000.0);
+    auto hc = h.coverage("C", he, 0.9, 0.5);
+    h.pass("R", hc.output);
+
+    sc_hw_cache::store cache(path);
+    g.set_coefficient(g.find("c"), 0, 0.9);
+    EXPECT_EQ(sc_hw_cache::node_hashes(h)[1], sc_hw_cache::node_hashes(g)[1]);
+
+    auto s = sc_hw_cache::evaluate(g, cache, outputs);
+    EXPECT_EQ(s.evaluated, 0u);
+    EXPECT_EQ(s.loaded, 3u);
+    EXPECT_DOUBLE_EQ(g.read(r), 100.0 + 1.0);
+    EXPECT_NE(sc_hw_cache::graph_hash(g), sc_hw_cache::graph_hash(h));
+
+    // Only the asil outputs requested: the residual is still current for
+    // the classification
+    g.set_coefficient(g.find("c"), 0, 0.0);
+    g.evaluate();
+    std::string level = g.asil_level(a);
+    g.set_coefficient(g.find("c"), 0, 0.99);
+    sc_hw_cache::evaluate(g, cache, {g.output(a, 0), g.output(a, 1)});
+    EXPECT_NE(g.asil_level(a), level);
+    g.evaluate();
+    level = g.asil_level(a);
+    g.set_coefficient(g.find("c"), 0, 0.0);
+    sc_hw_cache::evaluate(g, cache, {g.output(a, 0)});
+    g.set_coefficient(g.find("c"), 0, 0.99);
+    s = sc_hw_cache::evaluate(g, cache, {g.output(a, 0), g.output(a, 1)});
+    EXPECT_EQ(s.evaluated, 0u);
+    EXPECT_EQ(g.asil_level(a), level);
+
+    // A full store starts over
+    sc_hw_cache::store small(path + ".small", 2);
+    small.put(1, {1.0});
+    small.put(2, {2.0});
+    small.put(3, {3.0});
+    EXPECT_EQ(small.size(), 1u);
+    EXPECT_NE(small.find(3), nullptr);
+    small.close();
+    EXPECT_EQ(sc_hw_cache::store(path + ".small").size(), 1u);
+
+    std::remove((path + ".small").c_str());
+    std::remove(path.c_str());
+}
+
+TEST(hw_stochastic, philox) {
+    // Known answer of Philox4x32-10 for a zero counter and key
+    std::uint32_t counter[4] = {0, 0, 0, 0}, key[2] = {0, 0}, out[4];
+    sc_hw_stochastic::philox::block(counter, key, out);
+
+    EXPECT_EQ(out[0], 0x6627e8d5u);
+    EXPECT_EQ(out[1], 0xe169c58du);
+    EXPECT_EQ(out[2], 0xbc57ac4cu);
+    EXPECT_EQ(out[3], 0x9b00dbd8u);
+
+    // uniform takes the first word as the high half
+    sc_hw_stochastic::philox words(7, 3), uniforms(7, 3);
+    std::uint64_t high = words.next();
+    std::uint64_t low = words.next();
+    EXPECT_EQ(uniforms.uniform(), (((high << 32 | low) >> 11) + 0.5) * 0x1.0p-53);
+}
+
+TEST(hw_stochastic, replicas) {
+    // e feeds two coverages, a strongly covered event g is never observed
+    sc_hw_graph::graph g;
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto d = g.coverage("d", e, 0.5, 1.0);
+    auto s = g.split("s", g.basic_event("f", 200.0), {0.25, 0.5});
+    auto t = g.sum("t", {c.latent, d.output, s[1]});
+    g.coverage("h", g.basic_event("g", 1e12), 1.0, 1.0);
+    g.compile();
+
+    sc_hw_stochastic::options o;
+    o.hours = 1e10;
+    o.replicas = 32;
+    o.z = 4.0;
+
+    std::vector<sc_hw_graph::value> observed = {c.output, c.latent, s[0], t};
+    sc_hw_stochastic::simulator simulator(g, observed);
+    EXPECT_NEAR(simulator.observed_rate(), 1000.0 * (1 - 0.9 * 0.5 * 0.5) + 200.0 * 0.75, 1e-9);
+
+    sc_parallel::thread_pool one(1), two(2);
+    auto a = simulator.run(o, one);
+    auto b = simulator.run(o, two);
+
+    ASSERT_EQ(a.size(), 4u);
+    EXPECT_DOUBLE_EQ(a[0].analytic, 100.0);
+    EXPECT_DOUBLE_EQ(a[1].analytic, 500.0);
+    EXPECT_DOUBLE_EQ(a[3].analytic, 1100.0);
+
+    for (std::size_t i = 0; i < a.size(); i++) {
+        EXPECT_TRUE(a[i].covers_analytic()) << i << ": " << a[i];
+        EXPECT_EQ(a[i].arrivals, b[i].arrivals);
+        EXPECT_LT(a[i].upper - a[i].lower, 0.1 * a[i].analytic);
+    }
+}
+
+TEST(hw_graph, instances) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto a = g.asil("ASIL", c.output, c.latent, e);
+    g.compile();
+
+    std::vector<double> serial(64), parallel(64);
+    for (std::size_t i = 0; i < serial.size(); i++) {
+        g.set_coefficient(1, 0, i / 64.0);
+        g.evaluate();
+        serial[i] = g.lfm(a);
+    }
+    g.set_coefficient(1, 0, 0.9);
+
+    sc_parallel::thread_pool pool(4);
+    pool.parallel_for(parallel.size(), [&](std::size_t i) {
+        sc_hw_graph::instance s(g);
+        s.set_coefficient(1, 0, i / 64.0);
+        s.evaluate();
+        parallel[i] = s.lfm(a);
+    });
+
+    EXPECT_EQ(parallel, serial);
+    EXPECT_EQ(g.coefficient(1, 0), 0.9);
+}
+
+TEST(hw_graph, replicas) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto f = g.basic_event("f", 10.0);
+    auto s = g.split("s", e, {0.25, 0.75});
+    auto c = g.coverage("c", s[0], 0.9, 0.5);
+    auto r = g.sum("r", {c.output, s[1], f});
+    g.compile();
+
+    sc_hw_graph::replicas replicas(g, 16);
+    for (std::size_t i = 0; i < replicas.size(); i++) {
+        replicas.set_rate(g.find("e"), i, 100.0 * i);
+    }
+    replicas.evaluate();
+
+    double total = 0.0;
+    for (std::size_t i = 0; i < replicas.size(); i++) {
+        sc_hw_graph::instance s(g);
+        s.set_coefficient(g.find("e"), 0, 100.0 * i);
+        s.evaluate();
+        EXPECT_EQ(replicas.read(r, i), s.read(r));
+        EXPECT_EQ(replicas.read(c.latent, i), s.read(c.latent));
+        total += s.read(r);
+    }
+
+    EXPECT_DOUBLE_EQ(replicas.total(r), total);
+    EXPECT_EQ(replicas.read(f, 3), 10.0);
+    EXPECT_EQ(g.coefficient(g.find("e"), 0), 1000.0);
+}
+
+TEST(hw_graph, import) {
+    sc_signal<double> i("i", 100.0);
+    sc_signal<double> o1("o1");
+    sc_signal<double> o2("o2");
+    sc_signal<double> c1("c1");
+    sc_signal<double> l1("l1");
+    sc_signal<double> r("r");
+
+    sc_hw_metrics::split s("s");
+    sc_hw_metrics::coverage c("c", 0.9, 0.5);
+    sc_hw_metrics::sum sum("sum");
+
+    s.input.bind(i);
+    s.outputs.bind(o1, 0.87);
+    s.outputs.bind(o2, 0.13);
+    c.input.bind(o1);
+    c.output.bind(c1);
+    c.latent.bind(l1);
+    sum.inputs.bind(c1);
+    sum.inputs.bind(o2);
+    sum.output.bind(r);
+
+    sc_start();
+
+    sc_hw_graph::graph g;
+    auto map = sc_hw_graph::import_hierarchy(g);
+    g.evaluate();
+
+    EXPECT_EQ(g.size(), 4);
+    EXPECT_DOUBLE_EQ(g.read(map[r]), r.read());
+    EXPECT_DOUBLE_EQ(g.read(map[l1]), l1.read());
+
+    g.set_coefficient(g.find("i"), 0, 200.0);
+    g.evaluate();
+    EXPECT_DOUBLE_EQ(g.read(map[r]), 2 * r.read());
+}
+
+TEST(hw_server, graph) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto a = g.asil("ASIL", c.output, c.latent, e);
+    g.compile();
+
+    sc_hw_server::graph_server server(g, a);
+    bool quit;
+
+    EXPECT_EQ(server.handle("e=2000 c[1]=0.75", quit).substr(0, 3), "ok ");
+    EXPECT_EQ(g.coefficient(g.find("e"), 0), 2000.0);
+    EXPECT_EQ(g.coefficient(g.find("c"), 1), 0.75);
+    EXPECT_NEAR(g.read(c.output), 200.0, 1e-9);
+    EXPECT_FALSE(quit);
+
+    // Rejected requests change nothing
+    EXPECT_EQ(server.handle("e=5 x=1", quit), "error unknown parameter x");
+    EXPECT_EQ(server.handle("e=five", quit), "error not a number: e=five");
+    EXPECT_EQ(server.handle("e=5 c=1.5", quit), "error c out of range [0, 1]");
+    EXPECT_EQ(server.handle("e=-1", quit).substr(0, 24), "error e out of range [0,");
+    EXPECT_EQ(server.handle("e=nan", quit).substr(0, 22), "error e out of range [");
+    EXPECT_EQ(g.coefficient(g.find("e"), 0), 2000.0);
+    EXPECT_EQ(g.coefficient(g.find("c"), 0), 0.9);
+
+    // A stream of requests through a pipe
+    int in[2], out[2];
+    ASSERT_EQ(pipe(in), 0);
+    ASSERT_EQ(pipe(out), 0);
+    std::string requests = "e=1000\nc=0.99\nquit\ne=1\n";
+    ASSERT_EQ(write(in[1], requests.data(), requests.size()), ssize_t(requests.size()));
+    close(in[1]);
+
+    EXPECT_TRUE(server.serve(in[0], out[1]));
+    close(out[1]);
+
+    char buffer[1024];
+    ssize_t n = read(out[0], buffer, sizeof(buffer));
+    std::istringstream lines(std::string(buffer, std::max<ssize_t>(n, 0)));
+    std::string line, last;
+    int count = 0;
+    while (std::getline(lines, line)) {
+        last = line;
+        count++;
+    }
+    close(in[0]);
+    close(out[0]);
+
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(g.coefficient(g.find("e"), 0), 1000.0);
+    EXPECT_EQ(server.requests(), 4u);
+
+    double spfm, lfm, residual, latent;
+    std::string ok, level;
+    std::istringstream fields(last);
+    fields >> ok >> spfm >> lfm >> residual >> latent >> level;
+    EXPECT_EQ(ok, "ok");
+    EXPECT_NEAR(residual, 10.0, 1e-9);
+    EXPECT_DOUBLE_EQ(spfm, g.spfm(a));
+    EXPECT_EQ(level, g.asil_level(a));
+}
+
+TEST(hw_server, split) {
+    sc_hw_graph::graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto s = g.split("s", e, {0.5, 0.3});
+    auto d1 = g.basic_event("d", 1.0);
+    auto d2 = g.basic_event("d", 2.0);
+    auto u = g.basic_event("", 3.0);
+    auto r = g.sum("r", {s[0], d1, d2, u});
+    auto a = g.asil("ASIL", r, s[1], e);
+    g.compile();
+
+    sc_hw_server::graph_server server(g, a);
+    bool quit;
+
+    // The rates of a split may not add up to more than 1
+    EXPECT_EQ(server.handle("s=0.6", quit).substr(0, 3), "ok ");
+    EXPECT_EQ(server.handle("s=1 s[1]=1", quit), "error rates of s add up to more than 1");
+    EXPECT_EQ(server.handle("s[1]=0.5", quit), "error rates of s add up to more than 1");
+    EXPECT_EQ(g.coefficient(g.find("s"), 0), 0.6);
+    EXPECT_EQ(g.coefficient(g.find("s"), 1), 0.3);
+    EXPECT_EQ(server.handle("s[1]=0.5 s=0.5", quit).substr(0, 3), "ok ");
+    EXPECT_EQ(g.coefficient(g.find("s"), 0), 0.5);
+
+    // Shared names cannot be set, unnamed nodes have no parameters
+    EXPECT_EQ(server.handle("d=5", quit), "error ambiguous parameter d");
+    EXPECT_EQ(server.handle("e=5 d[0]=5", quit), "error ambiguous parameter d[0]");
+    EXPECT_FALSE(server.has_parameter("[0]"));
+    EXPECT_EQ(server.handle("e=500", quit).substr(0, 3), "ok ");
+    EXPECT_EQ(server.requests(), 3u);
+}
+
+TEST(hw_server, socket) {
+    sc_hw_graph::graph g;
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 0.5);
+    auto a = g.asil("ASIL", c.output, c.latent, e);
+    g.compile();
+    sc_hw_server::graph_server server(g, a);
+
+    // A regular file is never replaced by the socket
+    std::string path = testing::TempDir() + "hw_server.sock";
+    std::remove(path.c_str());
+    std::ofstream(path) << "notes";
+    EXPECT_THROW(server.serve_socket(path), sc_core::sc_report);
+    EXPECT_TRUE(std::ifstream(path).good());
+    std::remove(path.c_str());
+
+    auto connect = [&path]() {
+        int fd = -1;
+        for (int attempt = 0; attempt < 1000 && fd < 0; attempt++) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+            if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(fd);
+                fd = -1;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return fd;
+    };
+
+    // A client that leaves without reading its responses does not stop the
+    // server
+    std::string response;
+    std::thread clients([&]() {
+        int fd = connect();
+        std::string requests;
+        for (int i = 0; i < 2000; i++) {
+            requests += "e=1000\n";
+        }
+        EXPECT_EQ(write(fd, requests.data(), requests.size()), ssize_t(requests.size()));
+        close(fd);
+
+        fd = connect();
+        EXPECT_EQ(write(fd, "quit\n", 5), 5);
+        char buffer[256];
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        response.assign(buffer, std::max<ssize_t>(n, 0));
+        close(fd);
+    });
+
+    server.serve_socket(path);
+    clients.join();
+
+    EXPECT_EQ(response.substr(0, 3), "ok ");
+    EXPECT_FALSE(std::ifstream(path).good());
+}
+
+TEST(hw_server, model) {
+    sc_signal<double> fit("fit"), residual("residual"), latent("latent");
+
+    sc_hw_metrics::basic_event e("e", 1000.0);
+    sc_hw_metrics::coverage c("c", 0.9, 0.5);
+    sc_hw_metrics::asil a("a", 1000.0);
+
+    e.output.bind(fit);
+    c.input.bind(fit);
+    c.output.bind(residual);
+    c.latent.bind(latent);
+    a.residual.bind(residual);
+    a.latent.bind(latent);
+
+    sc_hw_server::model_server server(a);
+    server.parameter(e);
+    server.parameter(c);
+    bool quit;
+
+    EXPECT_EQ(server.handle("", quit).substr(0, 3), "ok ");
+    EXPECT_DOUBLE_EQ(residual.read(), 100.0);
+    EXPECT_DOUBLE_EQ(latent.read(), 500.0);
+
+    EXPECT_EQ(server.handle("c.dc=1.5", quit), "error c.dc out of range [0, 1]");
+    server.handle("c.dc=0.99 e=500", quit);
+    EXPECT_NEAR(residual.read(), 5.0, 1e-9);
+    EXPECT_DOUBLE_EQ(latent.read(), 250.0);
+    EXPECT_NEAR(a.spfm, 99.5, 1e-9);
+    EXPECT_TRUE(server.has_parameter("c.lc"));
+}
+
+TEST(hw_sweep, bisection) {
+    sc_hw_sweep::axis x{0.0, 1.0, 5, false};
+    auto classify = [](double v) { return int(v > 0.3) + int(v > 0.7) * 3; };
+
+    auto r = sc_hw_sweep::sweep(classify, x, 1e-4);
+
+    ASSERT_EQ(r.crossings.size(), 2u);
+    EXPECT_LE(r.crossings[0].lower, 0.3);
+    EXPECT_GT(r.crossings[0].upper, 0.3);
+    EXPECT_LE(r.crossings[0].upper - r.crossings[0].lower, 1e-4);
+    EXPECT_EQ(r.crossings[1].lower_asil, 1);
+    EXPECT_EQ(r.crossings[1].upper_asil, 4);
+    EXPECT_LE(r.crossings[1].lower, 0.7);
+    EXPECT_GT(r.crossings[1].upper, 0.7);
+    EXPECT_LT(r.evaluations(), 40u);
+    EXPECT_EQ(sc_hw_sweep::dense_points(x, 1e-4), 16385u);
+    EXPECT_DEATH(sc_hw_sweep::sweep(classify, sc_hw_sweep::axis{0.0, 1.0, 5, true}, 1e-4), "logarithmic");
+    EXPECT_TRUE(std::is_sorted(r.samples.begin(), r.samples.end(),
+                               [](auto& a, auto& b) { return a.x < b.x; }));
+}
+
+TEST(hw_sweep, quadtree) {
+    sc_hw_sweep::axis x{0.0, 1.0, 3, false};
+    sc_hw_sweep::axis y{1.0, 100.0, 3, true};
+    auto classify = [](double a, double b) { return int(a + std::log10(b) / 2 > 1.0); };
+
+    auto r = sc_hw_sweep::sweep(classify, x, y, 1.0 / 64);
+
+    EXPECT_FALSE(r.boundary.empty());
+    for (auto& c : r.boundary) {
+        EXPECT_EQ(c.lowest, 0);
+        EXPECT_EQ(c.highest, 1);
+        EXPECT_LE(c.x0 + std::log10(c.y0) / 2, 1.0);
+        EXPECT_GT(c.x1 + std::log10(c.y1) / 2, 1.0);
+    }
+    EXPECT_LT(r.evaluations(), sc_hw_sweep::dense_points(x, y, 1.0 / 64) / 4);
+
+    // The graph classifier gives the same crossing as the formula
+    sc_hw_graph::graph g;
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.9, 1.0);
+    auto other = g.basic_event("other", 1000.0);
+    auto a = g.asil("ASIL", c.output, c.latent, g.sum("total", {e, other}));
+    g.compile();
+
+    g.evaluate();
+    int before = g.asil_class(a);
+
+    sc_hw_graph::parameter dc{"c", 0};
+    auto s = sc_hw_sweep::sweep(sc_hw_sweep::classifier(g, a, dc), sc_hw_sweep::axis{0.0, 1.0, 11, false}, 1e-6);
+    EXPECT_EQ(g.coefficient(g.find("c"), 0), 0.9);
+    EXPECT_EQ(g.asil_class(a), before);
+    auto expected = [](double dc) {
+        double residual = 1000.0 * (1 - dc);
+        return sc_hw_metrics::asil_class(100 * (1 - residual / 2000.0), 100.0, residual);
+    };
+    ASSERT_FALSE(s.crossings.empty());
+    for (auto& x : s.crossings) {
+        EXPECT_EQ(expected(x.lower), x.lower_asil);
+        EXPECT_EQ(expected(x.upper), x.upper_asil);
+        EXPECT_LE(x.upper - x.lower, 1e-6);
+    }
+}
+
+TEST(hw_dse, pareto) {
+    using namespace sc_hw_dse;
+
+    auto build = [](interval_graph& g) {
+        auto e = g.basic_event("e", 1000.0);
+        auto s = g.split("s", e, {0.5, 0.5});
+        auto a = g.coverage("a", s[0], 0.0, 0.9);
+        auto b = g.coverage("b", s[1], 0.0, 0.9);
+        auto r = g.sum("r", {a.output, b.output});
+        auto l = g.sum("l", {a.latent, b.latent});
+        g.asil("ASIL", r, l, e);
+    };
+
+    std::vector<option> levels = {{"0%", 0.0, {0.0}}, {"90%", 1.0, {0.9}}, {"99%", 2.0, {0.99}}};
+    explorer dse(build, "ASIL", {{"A", {{"a", 0}}, levels}, {"B", {{"b", 0}}, levels}});
+
+    sc_parallel::thread_pool pool(2);
+    result r = dse.explore(sc_hw_metrics::asil_index("ASIL-B"), pool);
+
+    // Residual below 100 FIT needs 90% and 99% or better
+    EXPECT_EQ(r.configurations, 9);
+    EXPECT_EQ(r.feasible, 3);
+    EXPECT_GE(r.pruned, 3);
+    ASSERT_EQ(r.pareto.size(), 2);
+    EXPECT_DOUBLE_EQ(r.pareto[0].cost, 3.0);
+    EXPECT_DOUBLE_EQ(r.pareto[0].spfm, 94.5);
+    EXPECT_DOUBLE_EQ(r.pareto[1].cost, 4.0);
+    EXPECT_EQ(dse.describe(r.pareto[1]), "A=99%, B=99%");
+    EXPECT_EQ(r.pareto[1].asil_class, 3);
+}
+
+TEST(hw_solve, coverage) {
+    using namespace sc_hw_solve;
+    graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto c = g.coverage("c", e, 0.5, 0.95);
+    auto l = g.pass("l", c.latent);
+    g.asil("ASIL", c.output, l, e);
+
+    solver s(g, "ASIL");
+
+    // SPFM > 99% and residual < 10 FIT both need more than 99%
+    solution d = s.solve({{{"c", 0}}}, sc_hw_metrics::asil_index("ASIL-D"));
+    EXPECT_TRUE(d.feasible);
+    EXPECT_GT(d.value, 0.99);
+    EXPECT_NEAR(d.value, 0.99, 1e-8);
+    EXPECT_EQ(d.limiting, "SPFM");
+    EXPECT_LT(d.evaluations, 10);
+    EXPECT_DOUBLE_EQ(g.coefficient(g.find("c"), 0), 0.5);
+
+    // The latent coverage cannot fix the SPFM
+    solution lc = s.solve({{{"c", 1}}}, sc_hw_metrics::asil_index("ASIL-D"));
+    EXPECT_FALSE(lc.feasible);
+    EXPECT_EQ(lc.limiting, "SPFM");
+
+    // Already reached at the lower bound
+    solution a = s.solve({{{"c", 0}}, 0.5, 1.0}, sc_hw_metrics::asil_index("ASIL-A"));
+    EXPECT_TRUE(a.feasible);
+    EXPECT_DOUBLE_EQ(a.value, 0.5);
+}
+
+TEST(hw_solve, split) {
+    using namespace sc_hw_solve;
+    graph g;
+
+    auto e = g.basic_event("e", 1000.0);
+    auto s = g.split("s", e, {0.5});
+    auto l = g.basic_event("l", 0.0);
+    g.asil("ASIL", s[0], l, e);
+
+    // Largest residual share for SPFM > 90%
+    solution b = solver(g, "ASIL").solve({{{"s", 0}}, 1.0, 0.0}, sc_hw_metrics::asil_index("ASIL-B"));
+    EXPECT_TRUE(b.feasible);
+    EXPECT_LT(b.value, 0.1);
+    EXPECT_NEAR(b.value, 0.1, 1e-8);
+}
+
 int sc_main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
     int status = RUN_ALL_TESTS();
     return status;
-}
\ No newline at end of file
+}